@@ -0,0 +1,52 @@
+#include "BackgroundJob.hpp"
+#include <exception>
+
+void BackgroundJob::Context::step(double fraction, const char* stage) {
+    if (cancelled()) throw Cancelled{};
+    job_.progress_.store(fraction, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lk(job_.m_);
+    job_.stage_ = stage;
+}
+
+BackgroundJob::~BackgroundJob() {
+    cancel();
+    if (thread_.joinable()) thread_.join();
+}
+
+bool BackgroundJob::start(std::function<void(Context&)> fn) {
+    if (running()) return false;
+    if (thread_.joinable()) thread_.join();
+    cancel_.store(false, std::memory_order_relaxed);
+    progress_.store(0.0, std::memory_order_relaxed);
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stage_.clear();
+        error_.clear();
+    }
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this, fn = std::move(fn)] {
+        Context ctx(*this);
+        try {
+            fn(ctx);
+        } catch (const Cancelled&) {
+        } catch (const std::exception& e) {
+            std::lock_guard<std::mutex> lk(m_);
+            error_ = e.what();
+        } catch (...) {
+            std::lock_guard<std::mutex> lk(m_);
+            error_ = "unknown error";
+        }
+        running_.store(false, std::memory_order_release);
+    });
+    return true;
+}
+
+std::string BackgroundJob::stage() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return stage_;
+}
+
+std::string BackgroundJob::error() const {
+    std::lock_guard<std::mutex> lk(m_);
+    return error_;
+}
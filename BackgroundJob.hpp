@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+
+// One long-running job at a time on its own thread, with progress reporting and
+// cooperative cancellation. The job calls Context::step() between units of work;
+// step() records progress and throws Cancelled once cancel() has been requested,
+// so the job unwinds without publishing anything.
+class BackgroundJob {
+public:
+    struct Cancelled { };
+
+    class Context {
+    public:
+        explicit Context(BackgroundJob& job) : job_(job) { }
+        // fraction in [0, 1]; stage is a short label for the UI
+        void step(double fraction, const char* stage);
+        bool cancelled() const { return job_.cancel_.load(std::memory_order_relaxed); }
+    private:
+        BackgroundJob& job_;
+    };
+
+    BackgroundJob() = default;
+    ~BackgroundJob();
+
+    BackgroundJob(const BackgroundJob&) = delete;
+    BackgroundJob& operator=(const BackgroundJob&) = delete;
+
+    // Starts fn on the worker thread; returns false (and does nothing) while a
+    // previous job, possibly a cancelled one, is still running.
+    bool start(std::function<void(Context&)> fn);
+    void cancel() { cancel_.store(true, std::memory_order_relaxed); }
+
+    bool running() const { return running_.load(std::memory_order_acquire); }
+    bool cancelling() const { return running() && cancel_.load(std::memory_order_relaxed); }
+    double progress() const { return progress_.load(std::memory_order_relaxed); }
+    std::string stage() const;
+    // what() of the exception that ended the last job, empty if none
+    std::string error() const;
+
+private:
+    std::thread thread_;
+    std::atomic<bool> running_{false};
+    std::atomic<bool> cancel_{false};
+    std::atomic<double> progress_{0.0};
+    mutable std::mutex m_;
+    std::string stage_;
+    std::string error_;
+};
+
+// Double-buffered hand-off from a worker to the render thread. The worker fills a
+// value and publish()es it into the back slot; the render thread swaps it into its
+// front copy with take() at the start of a frame, so it never sees a half-built result.
+template <class T>
+class DoubleBuffer {
+public:
+    void publish(T value) {
+        std::lock_guard<std::mutex> lk(m_);
+        back_ = std::move(value);
+        fresh_ = true;
+    }
+
+    // swaps the newest published value into front; false if nothing new
+    bool take(T& front) {
+        std::lock_guard<std::mutex> lk(m_);
+        if (!fresh_) return false;
+        std::swap(front, back_);
+        fresh_ = false;
+        return true;
+    }
+
+    // Hands the worker the stale back value (the front replaced by the last take())
+    // to refill, so its buffers are reused instead of reallocated every time. Returns
+    // an empty T while an unread value is pending.
+    T reclaim() {
+        std::lock_guard<std::mutex> lk(m_);
+        if (fresh_) return T{};
+        return std::move(back_);
+    }
+
+private:
+    std::mutex m_;
+    T back_{};
+    bool fresh_ = false;
+};
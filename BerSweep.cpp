@@ -0,0 +1,134 @@
+#include "BerSweep.hpp"
+#include "BitStream.hpp"
+#include "Profiler.hpp"
+#include "StreamingCodec.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include <stdexcept>
+
+namespace {
+
+struct FrameBuffers {
+    BitStream source, decoded;
+    std::vector<float> clean, received;
+
+    size_t memory_bytes() const {
+        return (source.capacity() + decoded.capacity()) / 8 + (clean.capacity() + received.capacity()) * sizeof(float);
+    }
+};
+
+// The first n bits of frame `frame` (each frame owns ceil(frame_bits / 128) counters).
+// Frames are shared by every code and Eb/N0, common random numbers that keep the
+// curves smooth; the noise stream is distinct per (code, Eb/N0).
+void frame_bits(std::uint64_t seed, std::uint64_t frame, size_t frame_bits, size_t n, BitStream& out) {
+    out.clear();
+    out.reserve(n);
+    constexpr std::uint64_t bits_stream = ~std::uint64_t(0) >> 1;
+    for (size_t k = 0; k < n; k += 128) {
+        philox::Block b = philox::generate(frame * ((frame_bits + 127) / 128) + k / 128, bits_stream, seed);
+        std::uint64_t lo = (std::uint64_t)b[1] << 32 | b[0], hi = (std::uint64_t)b[3] << 32 | b[2];
+        size_t left = n - k;
+        out.append(lo, std::min<size_t>(64, left));
+        if (left > 64) out.append(hi, std::min<size_t>(64, left - 64));
+    }
+}
+
+std::uint64_t count_errors(const BitStream& a, const BitStream& b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t words = n / BitStream::word_bits;
+    std::uint64_t errors = 0;
+    for (size_t w = 0; w < words; ++w) errors += (std::uint64_t)popcount64(a.words()[w] ^ b.words()[w]);
+    for (size_t i = words * BitStream::word_bits; i < n; ++i) errors += a[i] != b[i];
+    // bits the decoder never produced count as errors
+    return errors + (a.size() - n);
+}
+
+} // namespace
+
+std::vector<BerCurve> ber_sweep(const BerSweepConfig& config, ThreadPool& pool,
+                                const std::function<void(double)>& progress) {
+    if (config.sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+    if (!(config.ebn0_step_db > 0.0) || config.ebn0_max_db < config.ebn0_min_db)
+        throw std::invalid_argument("invalid Eb/N0 range");
+    if (config.frame_bits == 0) throw std::invalid_argument("frame_bits must be positive");
+    DSG_PROFILE_SCOPE(prof, "ber_sweep");
+
+    std::vector<double> ebn0;
+    for (int i = 0;; ++i) {
+        double v = config.ebn0_min_db + i * config.ebn0_step_db;
+        if (v > config.ebn0_max_db + 1e-9) break;
+        ebn0.push_back(v);
+    }
+    size_t codes = config.codes.size(), points = ebn0.size();
+    size_t frames = (size_t)((config.bits_per_point + config.frame_bits - 1) / config.frame_bits);
+    size_t tasks = codes * points * frames;
+
+    std::unique_ptr<std::atomic<std::uint64_t>[]> errors(new std::atomic<std::uint64_t>[codes * points]);
+    for (size_t i = 0; i < codes * points; ++i) errors[i].store(0, std::memory_order_relaxed);
+    std::atomic<size_t> done{0};
+    std::atomic<bool> stop{false};
+
+    pool.parallel_for(tasks, [&](size_t t) {
+        if (stop.load(std::memory_order_relaxed)) return;
+        // frame-major order, so a partial run covers every point
+        size_t frame = t / (codes * points);
+        size_t point = t % (codes * points);
+        size_t c = point / points, p = point % points;
+        LineCode code = config.codes[c];
+        std::uint64_t first_bit = (std::uint64_t)frame * config.frame_bits;
+        size_t n = (size_t)std::min<std::uint64_t>(config.frame_bits, config.bits_per_point - first_bit);
+
+        DSG_PROFILE_SCOPE(frame_prof, "ber_frame");
+        thread_local FrameBuffers buf;
+        DSG_PROFILE_HEAP_BASE(frame_prof, buf.memory_bytes());
+        frame_bits(config.seed, frame, config.frame_bits, n, buf.source);
+        StreamEncoder enc(code, config.sampling_rate);
+        size_t spb = (size_t)enc.samples_per_bit();
+        if (spb == 0) throw std::invalid_argument("sampling_rate too small for line code");
+        buf.clean.resize(n * spb);
+        buf.received.resize(n * spb);
+        enc.encode(buf.source, buf.clean.data(), buf.clean.size());
+
+        ChannelModel channel;
+        channel.ebn0_db = ebn0[p];
+        channel.attenuation_db = config.attenuation_db;
+        channel.jitter = config.jitter;
+        channel.seed = config.seed;
+        apply_channel(channel, buf.clean.data(), buf.clean.size(), spb, first_bit * spb, buf.received.data(),
+                      (std::uint64_t)point);
+
+        buf.decoded.clear();
+        StreamDecoderF dec(code, config.sampling_rate);
+        dec.decode(buf.received.data(), buf.received.size(), buf.decoded);
+        errors[point].fetch_add(count_errors(buf.source, buf.decoded), std::memory_order_relaxed);
+        DSG_PROFILE_COUNT(frame_prof, n, buf.clean.size(), buf.memory_bytes());
+
+        if (progress) {
+            try {
+                progress((double)(done.fetch_add(1, std::memory_order_relaxed) + 1) / (double)tasks);
+            } catch (...) {
+                stop.store(true, std::memory_order_relaxed);
+                throw;
+            }
+        }
+    });
+
+    std::vector<BerCurve> curves(codes);
+    for (size_t c = 0; c < codes; ++c) {
+        curves[c].code = config.codes[c];
+        curves[c].points.resize(points);
+        for (size_t p = 0; p < points; ++p) {
+            BerPoint& pt = curves[c].points[p];
+            pt.ebn0_db = ebn0[p];
+            pt.bits = config.bits_per_point;
+            pt.errors = errors[c * points + p].load(std::memory_order_relaxed);
+        }
+    }
+    return curves;
+}
+
+double ber_antipodal(double ebn0_db) {
+    return 0.5 * std::erfc(std::sqrt(std::pow(10.0, ebn0_db / 10.0)));
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "Channel.hpp"
+#include "LineCode.hpp"
+#include "ThreadPool.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Monte-Carlo bit error rate vs Eb/N0. Random frames are encoded, passed through a
+// ChannelModel and decoded with the streaming codecs; errors are counted with XOR +
+// popcount. Work is split into (code, Eb/N0, frame) tasks on a ThreadPool, and every
+// random value comes from a counter-based stream, so results do not depend on the
+// thread count or scheduling.
+struct BerSweepConfig {
+    std::vector<LineCode> codes{LineCode::NRZ_L, LineCode::NRZ_I, LineCode::Manchester,
+                                LineCode::DifferentialManchester, LineCode::AMI};
+    double ebn0_min_db = 0.0;
+    double ebn0_max_db = 10.0;
+    double ebn0_step_db = 1.0;
+    std::uint64_t bits_per_point = 1000000;
+    int sampling_rate = 8;
+    double attenuation_db = 0.0;
+    double jitter = 0.0;           // rms, in bit periods
+    std::uint64_t seed = 1;
+    size_t frame_bits = 65536;     // bits per task; each frame restarts encoder and decoder
+};
+
+struct BerPoint {
+    double ebn0_db = 0.0;
+    std::uint64_t bits = 0;
+    std::uint64_t errors = 0;
+    double ber() const { return bits ? (double)errors / (double)bits : 0.0; }
+};
+
+struct BerCurve {
+    LineCode code = LineCode::NRZ_L;
+    std::vector<BerPoint> points;
+};
+
+// progress(fraction) is called from the worker threads after each frame; an exception
+// it throws (e.g. BackgroundJob::Cancelled) stops the sweep and is rethrown.
+std::vector<BerCurve> ber_sweep(const BerSweepConfig& config, ThreadPool& pool = ThreadPool::shared(),
+                                const std::function<void(double)>& progress = {});
+
+// Reference curve for antipodal signalling with a matched filter, Q(sqrt(2 Eb/N0));
+// NRZ-L and Manchester reach it on an AWGN channel.
+double ber_antipodal(double ebn0_db);
@@ -0,0 +1,165 @@
+#include "BitStream.hpp"
+#include <algorithm>
+#include <array>
+
+namespace {
+constexpr std::array<std::uint8_t, 256> make_rev8() {
+    std::array<std::uint8_t, 256> t{};
+    for (int i = 0; i < 256; ++i)
+        for (int b = 0; b < 8; ++b) t[i] |= (std::uint8_t)(((i >> b) & 1) << (7 - b));
+    return t;
+}
+constexpr auto rev8 = make_rev8();
+}
+
+std::uint64_t reverse_bits64(std::uint64_t w) {
+    std::uint64_t r = 0;
+    for (int i = 0; i < 8; ++i) r = (r << 8) | rev8[(w >> (8 * i)) & 0xFF];
+    return r;
+}
+
+BitStream::BitStream(std::size_t n, bool value)
+    : words_((n + word_bits - 1) / word_bits, value ? ~word_type(0) : 0), size_(n) {
+    trim();
+}
+
+BitStream::BitStream(const std::string& bits) {
+    size_ = bits.size();
+    words_.assign((size_ + word_bits - 1) / word_bits, 0);
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        std::size_t base = w * word_bits;
+        std::size_t n = std::min(word_bits, size_ - base);
+        word_type acc = 0;
+        for (std::size_t b = 0; b < n; ++b) acc |= word_type(bits[base + b] == '1') << b;
+        words_[w] = acc;
+    }
+}
+
+// byte-wise bit reversal of a word: MSB-first bytes <-> LSB-first bytes
+static std::uint64_t reverse_bytes_bits(std::uint64_t w) {
+    std::uint64_t r = 0;
+    for (int i = 0; i < 8; ++i) r |= std::uint64_t(rev8[(w >> (8 * i)) & 0xFF]) << (8 * i);
+    return r;
+}
+
+BitStream BitStream::from_bytes(const void* data, std::size_t bits, bool msb_first) {
+    BitStream s(bits);
+    const unsigned char* p = (const unsigned char*)data;
+    std::size_t bytes = (bits + 7) / 8;
+    for (std::size_t w = 0; w < s.words_.size(); ++w) {
+        std::size_t base = w * 8, n = std::min<std::size_t>(8, bytes - base);
+        word_type acc = 0;
+        for (std::size_t b = 0; b < n; ++b) acc |= word_type(p[base + b]) << (8 * b);
+        s.words_[w] = msb_first ? reverse_bytes_bits(acc) : acc;
+    }
+    s.trim();
+    return s;
+}
+
+void BitStream::to_bytes(void* out, bool msb_first) const {
+    unsigned char* p = (unsigned char*)out;
+    std::size_t bytes = (size_ + 7) / 8;
+    for (std::size_t w = 0; w < words_.size(); ++w) {
+        word_type v = msb_first ? reverse_bytes_bits(words_[w]) : words_[w];
+        std::size_t base = w * 8, n = std::min<std::size_t>(8, bytes - base);
+        for (std::size_t b = 0; b < n; ++b) p[base + b] = (unsigned char)(v >> (8 * b));
+    }
+}
+
+void BitStream::append(word_type bits, unsigned count) {
+    if (count == 0) return;
+    if (count < word_bits) bits &= (word_type(1) << count) - 1;
+    unsigned used = size_ % word_bits;
+    if (used == 0) {
+        words_.push_back(bits);
+    } else {
+        words_.back() |= bits << used;
+        if (used + count > word_bits) words_.push_back(bits >> (word_bits - used));
+    }
+    size_ += count;
+}
+
+void BitStream::append_msb(word_type value, unsigned count) {
+    if (count == 0) return;
+    append(reverse_bits64(value) >> (word_bits - count), count);
+}
+
+void BitStream::append(const BitStream& other) {
+    if (size_ % word_bits == 0) {
+        words_.insert(words_.end(), other.words_.begin(), other.words_.end());
+        size_ += other.size_;
+        return;
+    }
+    std::size_t full = other.size_ / word_bits;
+    for (std::size_t w = 0; w < full; ++w) append(other.words_[w], word_bits);
+    if (other.size_ % word_bits) append(other.words_[full], (unsigned)(other.size_ % word_bits));
+}
+
+BitStream::word_type BitStream::extract(std::size_t pos) const {
+    if (pos >= size_) return 0;
+    std::size_t w = pos / word_bits;
+    unsigned off = pos % word_bits;
+    word_type lo = words_[w] >> off;
+    if (off && w + 1 < words_.size()) lo |= words_[w + 1] << (word_bits - off);
+    return lo;
+}
+
+void BitStream::resize(std::size_t bits, bool value) {
+    std::size_t old = size_;
+    if (bits < old) {
+        words_.resize((bits + word_bits - 1) / word_bits);
+        size_ = bits;
+        trim();
+        return;
+    }
+    words_.resize((bits + word_bits - 1) / word_bits, value ? ~word_type(0) : 0);
+    size_ = bits;
+    if (value && old % word_bits) words_[old / word_bits] |= ~word_type(0) << (old % word_bits);
+    trim();
+}
+
+std::size_t BitStream::find_next(std::size_t pos, bool value) const {
+    if (pos >= size_) return size_;
+    std::size_t w = pos / word_bits;
+    word_type cur = (value ? words_[w] : ~words_[w]) & (~word_type(0) << (pos % word_bits));
+    while (true) {
+        if (cur) return std::min(size_, w * word_bits + ctz64(cur));
+        if (++w >= words_.size()) return size_;
+        cur = value ? words_[w] : ~words_[w];
+    }
+}
+
+std::size_t BitStream::count() const {
+    std::size_t c = 0;
+    for (word_type w : words_) c += popcount64(w);
+    return c;
+}
+
+std::size_t BitStream::count(std::size_t first, std::size_t last) const {
+    std::size_t c = 0;
+    for (std::size_t pos = first; pos < last; pos += word_bits) {
+        word_type w = extract(pos);
+        std::size_t n = last - pos;
+        if (n < word_bits) w &= (word_type(1) << n) - 1;
+        c += popcount64(w);
+    }
+    return c;
+}
+
+BitStream BitStream::substr(std::size_t pos, std::size_t len) const {
+    BitStream out;
+    if (pos >= size_) return out;
+    if (len > size_ - pos) len = size_ - pos;
+    out.reserve(len);
+    for (std::size_t i = 0; i < len; i += word_bits) {
+        std::size_t n = std::min(word_bits, len - i);
+        out.append(extract(pos + i), (unsigned)n);
+    }
+    return out;
+}
+
+std::string BitStream::to_string() const {
+    std::string s(size_, '0');
+    for (std::size_t i = 0; i < size_; ++i) if ((*this)[i]) s[i] = '1';
+    return s;
+}
@@ -0,0 +1,134 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// word helpers
+inline int popcount64(std::uint64_t w) {
+#if defined(_MSC_VER)
+    return (int)__popcnt64(w);
+#else
+    return __builtin_popcountll(w);
+#endif
+}
+
+// index of the lowest set bit; w must be non-zero
+inline int ctz64(std::uint64_t w) {
+#if defined(_MSC_VER)
+    unsigned long idx;
+    _BitScanForward64(&idx, w);
+    return (int)idx;
+#else
+    return __builtin_ctzll(w);
+#endif
+}
+
+// bit order reversal (bit 0 <-> bit 63)
+std::uint64_t reverse_bits64(std::uint64_t w);
+
+// Packed bit sequence. Bit i lives in word i/64 at position i%64 (LSB first);
+// bits past size() in the last word are always zero.
+class BitStream {
+public:
+    using word_type = std::uint64_t;
+    static constexpr std::size_t word_bits = 64;
+
+    class const_iterator {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = bool;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using reference = bool;
+
+        const_iterator() = default;
+        const_iterator(const BitStream* s, std::size_t i) : s_(s), i_(i) { }
+        bool operator*() const { return (*s_)[i_]; }
+        bool operator[](difference_type k) const { return (*s_)[i_ + k]; }
+        const_iterator& operator++() { ++i_; return *this; }
+        const_iterator operator++(int) { auto t = *this; ++i_; return t; }
+        const_iterator& operator--() { --i_; return *this; }
+        const_iterator operator--(int) { auto t = *this; --i_; return t; }
+        const_iterator& operator+=(difference_type k) { i_ += k; return *this; }
+        const_iterator& operator-=(difference_type k) { i_ -= k; return *this; }
+        const_iterator operator+(difference_type k) const { return {s_, i_ + k}; }
+        const_iterator operator-(difference_type k) const { return {s_, i_ - k}; }
+        difference_type operator-(const const_iterator& o) const { return (difference_type)i_ - (difference_type)o.i_; }
+        bool operator==(const const_iterator& o) const { return i_ == o.i_; }
+        bool operator!=(const const_iterator& o) const { return i_ != o.i_; }
+        bool operator<(const const_iterator& o) const { return i_ < o.i_; }
+        std::size_t index() const { return i_; }
+    private:
+        const BitStream* s_ = nullptr;
+        std::size_t i_ = 0;
+    };
+
+    BitStream() = default;
+    explicit BitStream(std::size_t n, bool value = false);
+    // '1' -> 1, anything else -> 0 (same rule the string encoders use)
+    explicit BitStream(const std::string& bits);
+    // `bits` bits from packed bytes, bit i = bit i%8 of byte i/8 (LSB-first bytes);
+    // msb_first reads bit i from bit 7 - i%8 instead
+    static BitStream from_bytes(const void* data, std::size_t bits, bool msb_first = false);
+    // the packed bytes back, ceil(size/8) of them, in the same layout
+    void to_bytes(void* out, bool msb_first = false) const;
+
+    std::size_t size() const { return size_; }
+    bool empty() const { return size_ == 0; }
+    std::size_t word_count() const { return words_.size(); }
+    const word_type* words() const { return words_.data(); }
+    word_type* words() { return words_.data(); }
+
+    bool operator[](std::size_t i) const { return (words_[i / word_bits] >> (i % word_bits)) & 1u; }
+    void set(std::size_t i, bool v) {
+        word_type m = word_type(1) << (i % word_bits);
+        if (v) words_[i / word_bits] |= m; else words_[i / word_bits] &= ~m;
+    }
+
+    void push_back(bool v) {
+        if (size_ % word_bits == 0) words_.push_back(0);
+        if (v) words_.back() |= word_type(1) << (size_ % word_bits);
+        ++size_;
+    }
+    // append the low `count` bits of `bits`, LSB first
+    void append(word_type bits, unsigned count);
+    // append the low `count` bits of `value`, MSB first (PCM code word order)
+    void append_msb(word_type value, unsigned count);
+    void append(const BitStream& other);
+
+    // 64 bits starting at bit `pos` (LSB = bit pos); bits past size() read as 0
+    word_type extract(std::size_t pos) const;
+
+    void reserve(std::size_t bits) { words_.reserve((bits + word_bits - 1) / word_bits); }
+    std::size_t capacity() const { return words_.capacity() * word_bits; }
+    void resize(std::size_t bits, bool value = false);
+    void clear() { words_.clear(); size_ = 0; }
+
+    // index of the first bit >= pos equal to `value`, or size() if there is none
+    std::size_t find_next(std::size_t pos, bool value) const;
+
+    std::size_t count() const;                       // number of ones
+    std::size_t count(std::size_t first, std::size_t last) const; // ones in [first, last)
+    BitStream substr(std::size_t pos, std::size_t len) const;
+    std::string to_string() const;
+
+    const_iterator begin() const { return {this, 0}; }
+    const_iterator end() const { return {this, size_}; }
+
+    bool operator==(const BitStream& o) const { return size_ == o.size_ && words_ == o.words_; }
+    bool operator!=(const BitStream& o) const { return !(*this == o); }
+
+private:
+    void trim() {
+        if (size_ % word_bits) words_.back() &= (word_type(1) << (size_ % word_bits)) - 1;
+    }
+
+    std::vector<word_type> words_;
+    std::size_t size_ = 0;
+};
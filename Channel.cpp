@@ -0,0 +1,196 @@
+#include "Channel.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DSG_X86_DISPATCH 1
+// the batch kernels below are inlined into per-ISA entry points
+#define DSG_INLINE inline __attribute__((always_inline))
+#else
+#define DSG_INLINE inline
+#endif
+
+namespace philox {
+
+static inline void mulhilo(std::uint32_t a, std::uint32_t b, std::uint32_t& hi, std::uint32_t& lo) {
+    std::uint64_t p = (std::uint64_t)a * b;
+    hi = (std::uint32_t)(p >> 32);
+    lo = (std::uint32_t)p;
+}
+
+Block generate(std::uint64_t counter, std::uint64_t stream, std::uint64_t key) {
+    std::uint32_t c0 = (std::uint32_t)counter, c1 = (std::uint32_t)(counter >> 32);
+    std::uint32_t c2 = (std::uint32_t)stream, c3 = (std::uint32_t)(stream >> 32);
+    std::uint32_t k0 = (std::uint32_t)key, k1 = (std::uint32_t)(key >> 32);
+    for (int round = 0; round < 10; ++round) {
+        std::uint32_t hi0, lo0, hi1, lo1;
+        mulhilo(0xD2511F53u, c0, hi0, lo0);
+        mulhilo(0xCD9E8D57u, c2, hi1, lo1);
+        std::uint32_t n0 = hi1 ^ c1 ^ k0, n2 = hi0 ^ c3 ^ k1;
+        c0 = n0; c1 = lo1; c2 = n2; c3 = lo0;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    return {c0, c1, c2, c3};
+}
+
+// generate() for `lanes` consecutive counters at once, structure-of-arrays, so the
+// rounds vectorize (32x32->64 multiplies); out gets the blocks one after another.
+template <size_t lanes>
+static DSG_INLINE void generate_lanes(std::uint64_t counter, std::uint64_t stream, std::uint64_t key, std::uint32_t* out) {
+    std::uint32_t c0[lanes], c1[lanes], c2[lanes], c3[lanes];
+    for (size_t l = 0; l < lanes; ++l) {
+        c0[l] = (std::uint32_t)(counter + l);
+        c1[l] = (std::uint32_t)((counter + l) >> 32);
+        c2[l] = (std::uint32_t)stream;
+        c3[l] = (std::uint32_t)(stream >> 32);
+    }
+    std::uint32_t k0 = (std::uint32_t)key, k1 = (std::uint32_t)(key >> 32);
+    for (int round = 0; round < 10; ++round) {
+        for (size_t l = 0; l < lanes; ++l) {
+            std::uint64_t p0 = (std::uint64_t)0xD2511F53u * c0[l];
+            std::uint64_t p1 = (std::uint64_t)0xCD9E8D57u * c2[l];
+            std::uint32_t n0 = (std::uint32_t)(p1 >> 32) ^ c1[l] ^ k0;
+            std::uint32_t n2 = (std::uint32_t)(p0 >> 32) ^ c3[l] ^ k1;
+            c1[l] = (std::uint32_t)p1;
+            c3[l] = (std::uint32_t)p0;
+            c0[l] = n0;
+            c2[l] = n2;
+        }
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    for (size_t l = 0; l < lanes; ++l) {
+        out[4 * l] = c0[l]; out[4 * l + 1] = c1[l]; out[4 * l + 2] = c2[l]; out[4 * l + 3] = c3[l];
+    }
+}
+
+// ln(x), x in (0, 1]: exponent plus the odd series of atanh((m-1)/(m+1)), m in [1, 2);
+// absolute error below 1e-6.
+static DSG_INLINE float log_unit(float x) {
+    std::uint32_t b;
+    std::memcpy(&b, &x, 4);
+    float e = (float)((int)(b >> 23) - 127);
+    b = (b & 0x7FFFFFu) | 0x3F800000u;
+    float m;
+    std::memcpy(&m, &b, 4);
+    float t = (m - 1.0f) / (m + 1.0f), t2 = t * t;
+    float series = 1.0f + t2 * (1.0f / 3 + t2 * (1.0f / 5 + t2 * (1.0f / 7 + t2 * (1.0f / 9))));
+    return e * 0.69314718f + 2.0f * t * series;
+}
+
+// Box-Muller on word pairs with polynomial log / sincos (no libm calls, so batches
+// vectorize). The angle is a quadrant from the top two bits plus an offset in
+// [-pi/4, pi/4) from the next 22, which is uniform on the circle.
+static DSG_INLINE void box_muller(std::uint32_t w0, std::uint32_t w1, float& z0, float& z1) {
+    float r = std::sqrt(-2.0f * log_unit(1.0f - uniform(w0)));
+    unsigned q = w1 >> 30;
+    float x = ((float)((w1 >> 8) & 0x3FFFFFu) * (1.0f / 4194304.0f) - 0.5f) * 1.57079633f;
+    float x2 = x * x;
+    float s = x * (1.0f - x2 * (1.0f / 6 - x2 * (1.0f / 120 - x2 * (1.0f / 5040))));
+    float c = 1.0f - x2 * (0.5f - x2 * (1.0f / 24 - x2 * (1.0f / 720 - x2 * (1.0f / 40320))));
+    // rotate (c, s) by q quarter turns
+    float cq = q == 0 ? c : q == 1 ? -s : q == 2 ? -c : s;
+    float sq = q == 0 ? s : q == 1 ? c : q == 2 ? -s : -c;
+    z0 = r * cq;
+    z1 = r * sq;
+}
+
+constexpr size_t lanes = 16;
+
+template <size_t n>
+static DSG_INLINE void gaussian_lanes_body(std::uint64_t counter, std::uint64_t stream, std::uint64_t key, float* out) {
+    std::uint32_t w[4 * n];
+    generate_lanes<n>(counter, stream, key, w);
+    for (size_t i = 0; i < 4 * n; i += 2) box_muller(w[i], w[i + 1], out[i], out[i + 1]);
+}
+
+// Same arithmetic on every path (no FMA contraction), so results do not depend on the ISA.
+static void gaussian_lanes(std::uint64_t counter, std::uint64_t stream, std::uint64_t key, float* out) {
+    gaussian_lanes_body<lanes>(counter, stream, key, out);
+}
+
+#if DSG_X86_DISPATCH
+__attribute__((target("avx2"))) static void gaussian_lanes_avx2(std::uint64_t counter, std::uint64_t stream,
+                                                                 std::uint64_t key, float* out) {
+    gaussian_lanes_body<lanes>(counter, stream, key, out);
+}
+#endif
+
+void gaussian(std::uint64_t counter, std::uint64_t stream, std::uint64_t key, size_t blocks, float* out) {
+    size_t b = 0;
+#if DSG_X86_DISPATCH
+    if (simd::active_level() >= simd::Level::AVX2) {
+        for (; b + lanes <= blocks; b += lanes, out += 4 * lanes) gaussian_lanes_avx2(counter + b, stream, key, out);
+    }
+#endif
+    for (; b + lanes <= blocks; b += lanes, out += 4 * lanes) gaussian_lanes(counter + b, stream, key, out);
+    for (; b < blocks; ++b, out += 4) {
+        Block g = generate(counter + b, stream, key);
+        box_muller(g[0], g[1], out[0], out[1]);
+        box_muller(g[2], g[3], out[2], out[3]);
+    }
+}
+
+} // namespace philox
+
+double ChannelModel::gain() const {
+    return std::pow(10.0, -attenuation_db / 20.0);
+}
+
+double ChannelModel::noise_sigma(size_t samples_per_bit) const {
+    if (std::isinf(ebn0_db) && ebn0_db > 0) return 0.0;
+    double ebn0 = std::pow(10.0, ebn0_db / 10.0);
+    return std::sqrt((double)samples_per_bit / (2.0 * ebn0));
+}
+
+// Counter streams: noise and jitter use separate halves of the stream word.
+static constexpr std::uint64_t jitter_stream_bit = std::uint64_t(1) << 63;
+
+void apply_channel(const ChannelModel& channel, const float* clean, size_t n, size_t samples_per_bit,
+                   std::uint64_t first_sample, float* out, std::uint64_t stream) {
+    if (n == 0) return;
+    DSG_PROFILE_SCOPE(prof, "channel");
+    DSG_PROFILE_COUNT(prof, n / std::max<size_t>(1, samples_per_bit), n, 0);
+    float g = (float)channel.gain();
+    float sigma = (float)channel.noise_sigma(samples_per_bit);
+    size_t spb = std::max<size_t>(1, samples_per_bit);
+
+    if (channel.jitter > 0.0) {
+        float rms = (float)(channel.jitter * (double)spb);
+        std::uint64_t bit = first_sample / spb;
+        size_t i = 0;
+        float z[4];
+        while (i < n) {
+            if (i == 0 || bit % 4 == 0) philox::gaussian4(bit / 4, stream | jitter_stream_bit, channel.seed, z);
+            // shift of this bit, limited to half a bit so bits keep their order
+            long shift = std::lround(std::max(-0.5f * spb, std::min(0.5f * spb, rms * z[bit % 4])));
+            size_t end = std::min<std::uint64_t>(n, (bit + 1) * spb - first_sample);
+            for (; i < end; ++i) {
+                long src = std::max(0L, std::min((long)n - 1, (long)i - shift));
+                out[i] = g * clean[src];
+            }
+            ++bit;
+        }
+    } else {
+        for (size_t i = 0; i < n; ++i) out[i] = g * clean[i];
+    }
+
+    if (sigma == 0.0f) return;
+    // four noise values per counter; whole batches go through gaussian()
+    constexpr size_t batch = 256;
+    float z[batch];
+    size_t i = 0;
+    std::uint64_t index = first_sample;
+    while (i < n) {
+        size_t lead = (size_t)(index % 4);
+        size_t take = std::min(n - i, batch - lead);
+        philox::gaussian(index / 4, stream, channel.seed, (lead + take + 3) / 4, z);
+        for (size_t k = 0; k < take; ++k) out[i + k] += sigma * z[lead + k];
+        i += take;
+        index += take;
+    }
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Philox4x32-10 counter-based generator (Salmon et al., SC'11). Every output block is
+// a pure function of (counter, key), so any sample of any stream can be produced
+// independently and in any order: parallel and chunked runs reproduce exactly.
+namespace philox {
+
+using Block = std::array<std::uint32_t, 4>;
+
+Block generate(std::uint64_t counter, std::uint64_t stream, std::uint64_t key);
+
+// 4 * blocks N(0, 1) values from counters [counter, counter + blocks) of `stream`
+// (Box-Muller, four per counter; accurate to about 1e-6)
+void gaussian(std::uint64_t counter, std::uint64_t stream, std::uint64_t key, size_t blocks, float* out);
+inline void gaussian4(std::uint64_t counter, std::uint64_t stream, std::uint64_t key, float out[4]) {
+    gaussian(counter, stream, key, 1, out);
+}
+
+// uniform in [0, 1) from the top 24 bits of a word
+inline float uniform(std::uint32_t v) { return (float)(v >> 8) * (1.0f / 16777216.0f); }
+
+} // namespace philox
+
+// Noisy link applied to line-coded samples: attenuation, additive white Gaussian
+// noise and per-bit timing jitter. Eb/N0 is referred to the transmitted unit
+// amplitude (Eb = samples_per_bit, noise variance N0/2 per sample), so attenuation
+// lowers the effective Eb/N0 at the receiver.
+struct ChannelModel {
+    double ebn0_db = std::numeric_limits<double>::infinity();   // infinity = no noise
+    double attenuation_db = 0.0;
+    double jitter = 0.0;       // rms timing offset of each bit, in bit periods
+    std::uint64_t seed = 1;
+
+    double gain() const;
+    double noise_sigma(size_t samples_per_bit) const;
+};
+
+// Writes the received samples [first_sample, first_sample + n) of a stream with
+// samples_per_bit samples per bit; clean holds the same range of the transmitted
+// signal. Bit k is displaced by its jitter offset (samples taken from outside the
+// range are clamped to it). The random values depend only on (seed, stream, sample
+// or bit index), never on the chunking.
+void apply_channel(const ChannelModel& channel, const float* clean, size_t n, size_t samples_per_bit,
+                   std::uint64_t first_sample, float* out, std::uint64_t stream = 0);
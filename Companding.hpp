@@ -0,0 +1,101 @@
+#pragma once
+#include <array>
+#include <cstdint>
+
+// G.711 companding laws for 8-bit PCM code words.
+enum class Companding { MuLaw, ALaw };
+
+inline const char* companding_name(Companding law) {
+    return law == Companding::MuLaw ? "mu-law" : "A-law";
+}
+
+namespace g711 {
+
+// Segment search and code construction as in the ITU-T G.711 reference (Sun g711.c).
+constexpr int segment(int value, const int (&ends)[8]) {
+    for (int i = 0; i < 8; ++i) if (value <= ends[i]) return i;
+    return 8;
+}
+
+// 14-bit signed linear sample -> mu-law code word
+constexpr std::uint8_t mulaw_from_linear14(int pcm) {
+    constexpr int seg_uend[8] = {0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF, 0x1FFF};
+    int mask = 0xFF;
+    if (pcm < 0) { pcm = -pcm; mask = 0x7F; }
+    if (pcm > 8159) pcm = 8159;
+    pcm += 33;
+    int seg = segment(pcm, seg_uend);
+    if (seg >= 8) return (std::uint8_t)(0x7F ^ mask);
+    return (std::uint8_t)(((seg << 4) | ((pcm >> (seg + 1)) & 0xF)) ^ mask);
+}
+
+// 13-bit signed linear sample -> A-law code word
+constexpr std::uint8_t alaw_from_linear13(int pcm) {
+    constexpr int seg_aend[8] = {0x1F, 0x3F, 0x7F, 0xFF, 0x1FF, 0x3FF, 0x7FF, 0xFFF};
+    int mask = 0xD5;
+    if (pcm < 0) { mask = 0x55; pcm = -pcm - 1; }
+    int seg = segment(pcm, seg_aend);
+    if (seg >= 8) return (std::uint8_t)(0x7F ^ mask);
+    int aval = seg << 4;
+    aval |= seg < 2 ? (pcm >> 1) & 0xF : (pcm >> seg) & 0xF;
+    return (std::uint8_t)(aval ^ mask);
+}
+
+// code word -> 16-bit linear sample
+constexpr std::int16_t mulaw_to_linear(std::uint8_t code) {
+    int u = ~code & 0xFF;
+    int t = (((u & 0xF) << 3) + 0x84) << ((u & 0x70) >> 4);
+    return (std::int16_t)((u & 0x80) ? 0x84 - t : t - 0x84);
+}
+
+constexpr std::int16_t alaw_to_linear(std::uint8_t code) {
+    int a = code ^ 0x55;
+    int t = (a & 0xF) << 4;
+    int seg = (a & 0x70) >> 4;
+    if (seg == 0) t += 8;
+    else t = (t + 0x108) << (seg - 1);
+    return (std::int16_t)((a & 0x80) ? t : -t);
+}
+
+constexpr std::array<std::uint8_t, 1 << 14> make_mulaw_table() {
+    std::array<std::uint8_t, 1 << 14> t{};
+    for (int i = 0; i < (1 << 14); ++i) t[i] = mulaw_from_linear14(i - (1 << 13));
+    return t;
+}
+
+constexpr std::array<std::uint8_t, 1 << 13> make_alaw_table() {
+    std::array<std::uint8_t, 1 << 13> t{};
+    for (int i = 0; i < (1 << 13); ++i) t[i] = alaw_from_linear13(i - (1 << 12));
+    return t;
+}
+
+template <std::int16_t (*Expand)(std::uint8_t)>
+constexpr std::array<std::int16_t, 256> make_expand_table() {
+    std::array<std::int16_t, 256> t{};
+    for (int i = 0; i < 256; ++i) t[i] = Expand((std::uint8_t)i);
+    return t;
+}
+
+// Compile-time lookup tables, indexed by the top 14 / 13 bits of a 16-bit sample
+// (offset to be non-negative) and by code word respectively.
+inline constexpr auto mulaw_encode_table = make_mulaw_table();
+inline constexpr auto alaw_encode_table = make_alaw_table();
+inline constexpr auto mulaw_decode_table = make_expand_table<mulaw_to_linear>();
+inline constexpr auto alaw_decode_table = make_expand_table<alaw_to_linear>();
+
+static_assert(mulaw_encode_table[(1 << 13)] == 0xFF, "mu-law of 0");
+static_assert(alaw_encode_table[(1 << 12)] == 0xD5, "A-law of 0");
+static_assert(mulaw_decode_table[0xFF] == 0 && alaw_decode_table[0xD5] == 8, "expansion of 0");
+
+} // namespace g711
+
+// 16-bit linear sample -> 8-bit code word
+inline std::uint8_t compress_sample(Companding law, std::int16_t pcm) {
+    return law == Companding::MuLaw ? g711::mulaw_encode_table[(pcm >> 2) + (1 << 13)]
+                                    : g711::alaw_encode_table[(pcm >> 3) + (1 << 12)];
+}
+
+// 8-bit code word -> 16-bit linear sample
+inline std::int16_t expand_sample(Companding law, std::uint8_t code) {
+    return law == Companding::MuLaw ? g711::mulaw_decode_table[code] : g711::alaw_decode_table[code];
+}
@@ -1,211 +1,444 @@
 #include "DigitalSignalGenerator.hpp"
+#include "Palindrome.hpp"
+#include "ParallelCodec.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
 #include <algorithm>
 #include <cmath>
-#include <sstream>
 #include <stdexcept>
-#include <numeric>
 
 DigitalSignalGenerator::DigitalSignalGenerator(double bit_duration_, int sampling_rate_)
     : bit_duration(bit_duration_), sampling_rate(sampling_rate_) { }
 
 std::string DigitalSignalGenerator::pcm_encode(const std::vector<double>& analog_signal, int n_bits) const {
-    if (analog_signal.size() < 2) throw std::invalid_argument("Signal needs at least 2 samples");
-    double mn = *std::min_element(analog_signal.begin(), analog_signal.end());
-    double mx = *std::max_element(analog_signal.begin(), analog_signal.end());
-    double range = mx - mn;
-    if (range == 0) range = 1e-10;
-    int levels = 1 << n_bits;
-    std::ostringstream out;
-    for (double v : analog_signal) {
-        double normalized = (v - mn) / range;
-        int quant = static_cast<int>(std::floor(normalized * (levels - 1)));
-        for (int b = n_bits - 1; b >= 0; --b) out << ((quant >> b) & 1);
-    }
-    return out.str();
+    return pcm_encode_bits(analog_signal, n_bits).to_string();
 }
 
 std::string DigitalSignalGenerator::delta_modulation(const std::vector<double>& analog_signal, double step_size) const {
-    if (analog_signal.empty()) return {};
-    std::ostringstream out;
-    double approximation = analog_signal.front();
-    for (double sample : analog_signal) {
-        if (sample > approximation) {
-            out << '1';
-            approximation += step_size;
-        } else {
-            out << '0';
-            approximation -= step_size;
-        }
+    return delta_modulation_bits(analog_signal, step_size).to_string();
+}
+
+BitStream DigitalSignalGenerator::pcm_encode_bits(const std::vector<double>& analog_signal, int n_bits) const {
+    if (analog_signal.size() < 2) throw std::invalid_argument("Signal needs at least 2 samples");
+    DSG_PROFILE_SCOPE(prof, "pcm_encode");
+    double mn, mx;
+    simd::min_max(analog_signal.data(), analog_signal.size(), mn, mx);
+    PcmEncoder pcm(mn, mx, n_bits);
+    BitStream out;
+    out.reserve(analog_signal.size() * n_bits);
+    pcm.encode(analog_signal.data(), analog_signal.size(), out);
+    pcm.finish(out);
+    DSG_PROFILE_COUNT(prof, out.size(), analog_signal.size(), out.capacity() / 8);
+    return out;
+}
+
+// The signal is taken as bipolar around 0 and scaled so its peak magnitude maps to
+// 16-bit full scale, then compressed to 8-bit code words through the G.711 tables.
+BitStream DigitalSignalGenerator::pcm_encode_companded(const std::vector<double>& analog_signal, Companding law) const {
+    if (analog_signal.empty()) throw std::invalid_argument("Signal needs at least 1 sample");
+    DSG_PROFILE_SCOPE(prof, "pcm_encode_companded");
+    double mn, mx;
+    simd::min_max(analog_signal.data(), analog_signal.size(), mn, mx);
+    PcmEncoder pcm(std::max(std::abs(mn), std::abs(mx)), law);
+    BitStream out;
+    out.reserve(analog_signal.size() * 8);
+    pcm.encode(analog_signal.data(), analog_signal.size(), out);
+    pcm.finish(out);
+    DSG_PROFILE_COUNT(prof, out.size(), analog_signal.size(), out.capacity() / 8);
+    return out;
+}
+
+std::vector<double> DigitalSignalGenerator::pcm_decode_companded(const BitStream& bits, Companding law, double peak) const {
+    DSG_PROFILE_SCOPE(prof, "pcm_decode_companded");
+    std::vector<double> out(bits.size() / 8);
+    for (size_t i = 0; i < out.size(); ++i) {
+        std::uint8_t code = (std::uint8_t)(reverse_bits64(bits.extract(i * 8)) >> 56);
+        out[i] = expand_sample(law, code) / 32768.0 * peak;
     }
-    return out.str();
+    DSG_PROFILE_COUNT(prof, bits.size(), out.size(), out.capacity() * sizeof(double));
+    return out;
 }
 
-std::tuple<std::string,int,int> DigitalSignalGenerator::longest_palindrome_manacher(const std::string& s) const {
-    if (s.empty()) return {"",0,0};
-    std::string t;
-    t.reserve(s.size()*2 + 3);
-    t.push_back('^');
-    for (char c : s) { t.push_back('#'); t.push_back(c); }
-    t.push_back('#');
-    t.push_back('$');
-    int n = static_cast<int>(t.size());
+BitStream DigitalSignalGenerator::delta_modulation_bits(const std::vector<double>& analog_signal, double step_size) const {
+    DSG_PROFILE_SCOPE(prof, "delta_modulation");
+    BitStream out;
+    out.reserve(analog_signal.size());
+    DeltaModulator(step_size).encode(analog_signal.data(), analog_signal.size(), out);
+    DSG_PROFILE_COUNT(prof, out.size(), analog_signal.size(), out.capacity() / 8);
+    return out;
+}
+
+// Manacher over the virtual separator string t = ^#c0#c1#...#c(n-1)#$ ; t is never materialized,
+// at(k) returns the k-th character of t.
+template <class At>
+static std::pair<int,int> manacher(int len, At at) {
+    DSG_PROFILE_SCOPE(prof, "longest_palindrome_manacher");
+    int n = 2*len + 3;
+    auto t = [&](int k) -> int {
+        if (k == 0) return '^';
+        if (k == n-1) return '$';
+        return (k & 1) ? '#' : at(k/2 - 1);
+    };
     std::vector<int> P(n,0);
     int center = 0, right = 0;
     for (int i = 1; i < n-1; ++i) {
         int mirror = 2*center - i;
         if (i < right) P[i] = std::min(right - i, P[mirror]);
-        while (t[i+1+P[i]] == t[i-1-P[i]]) ++P[i];
+        while (t(i+1+P[i]) == t(i-1-P[i])) ++P[i];
         if (i + P[i] > right) { center = i; right = i + P[i]; }
     }
     int max_len = 0, center_idx = 0;
     for (int i = 1; i < n-1; ++i) if (P[i] > max_len) { max_len = P[i]; center_idx = i; }
+    DSG_PROFILE_COUNT(prof, len, 0, P.capacity() * sizeof(int));
+    if (max_len==0) return {0,0};
+    return {(center_idx - max_len - 1) / 2, max_len};
+}
+
+std::tuple<std::string,int,int> DigitalSignalGenerator::longest_palindrome_manacher(const std::string& s) const {
+    if (s.empty()) return {"",0,0};
+    auto [start, max_len] = manacher((int)s.size(), [&](int k) { return (int)(unsigned char)s[k]; });
     if (max_len==0) return {"",0,0};
-    int start = (center_idx - max_len - 1) / 2;
-    std::string pal = s.substr(start, max_len);
-    return {pal, start, max_len};
+    return {s.substr(start, max_len), start, max_len};
 }
 
-static inline void append_samples(std::vector<double>& time, std::vector<double>& signal, double t0, double t1, int samples, double value) {
-    double dt = (t1 - t0) / samples;
-    for (int i = 0; i < samples; ++i) {
-        time.push_back(t0 + i * dt);
-        signal.push_back(value);
-    }
+std::tuple<BitStream,std::uint64_t,std::uint64_t> DigitalSignalGenerator::longest_palindrome_manacher(const BitStream& s) const {
+    Palindrome p = longest_palindrome(s);
+    if (p.length == 0) return {BitStream(),0,0};
+    return {s.substr((size_t)p.start, (size_t)p.length), p.start, p.length};
+}
+
+template <class T>
+static void encode_into(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, BasicSampledSignal<T>& out) {
+    DSG_PROFILE_SCOPE(prof, "encode");
+    DSG_PROFILE_HEAP_BASE(prof, out.samples.capacity() * sizeof(T));
+    StreamEncoder enc(code, sampling_rate);
+    out.t0 = 0.0;
+    out.dt = bit_duration / enc.samples_per_bit();
+    out.samples.resize(data.size() * enc.samples_per_bit());
+    enc.encode(data, out.samples.data(), out.samples.size());
+    DSG_PROFILE_COUNT(prof, data.size(), out.samples.size(), out.samples.capacity() * sizeof(T));
+}
+
+template <class T>
+static BasicSampledSignal<T> encode_as(LineCode code, const BitStream& data, double bit_duration, int sampling_rate) {
+    BasicSampledSignal<T> out;
+    encode_into(code, data, bit_duration, sampling_rate, out);
+    return out;
+}
+
+SampledSignal DigitalSignalGenerator::encode(LineCode code, const BitStream& data) const {
+    return encode_as<double>(code, data, bit_duration, sampling_rate);
+}
+
+SampledSignalF DigitalSignalGenerator::encode_f32(LineCode code, const BitStream& data) const {
+    return encode_as<float>(code, data, bit_duration, sampling_rate);
+}
+
+SampledSignalI8 DigitalSignalGenerator::encode_i8(LineCode code, const BitStream& data) const {
+    return encode_as<std::int8_t>(code, data, bit_duration, sampling_rate);
+}
+
+RunLengthSignal DigitalSignalGenerator::encode_runs(LineCode code, const BitStream& data) const {
+    RunLengthSignal out;
+    encode_runs(code, data, out);
+    return out;
+}
+
+void DigitalSignalGenerator::encode(LineCode code, const BitStream& data, SampledSignal& out) const {
+    encode_into(code, data, bit_duration, sampling_rate, out);
+}
+
+void DigitalSignalGenerator::encode(LineCode code, const BitStream& data, SampledSignalF& out) const {
+    encode_into(code, data, bit_duration, sampling_rate, out);
+}
+
+void DigitalSignalGenerator::encode(LineCode code, const BitStream& data, SampledSignalI8& out) const {
+    encode_into(code, data, bit_duration, sampling_rate, out);
+}
+
+void DigitalSignalGenerator::encode_runs(LineCode code, const BitStream& data, RunLengthSignal& out) const {
+    DSG_PROFILE_SCOPE(prof, "encode_runs");
+    DSG_PROFILE_HEAP_BASE(prof, out.memory_bytes());
+    ::encode_runs(code, data, bit_duration, sampling_rate, out);
+    DSG_PROFILE_COUNT(prof, data.size(), out.count, out.memory_bytes());
+}
+
+SampledSignal DigitalSignalGenerator::encode_parallel(LineCode code, const BitStream& data) const {
+    DSG_PROFILE_SCOPE(prof, "encode_parallel");
+    SampledSignal out = parallel::encode(code, data, bit_duration, sampling_rate);
+    DSG_PROFILE_COUNT(prof, data.size(), out.samples.size(), out.samples.capacity() * sizeof(double));
+    return out;
+}
+
+SampledSignalF DigitalSignalGenerator::encode_parallel_f32(LineCode code, const BitStream& data) const {
+    DSG_PROFILE_SCOPE(prof, "encode_parallel");
+    SampledSignalF out = parallel::encode_f32(code, data, bit_duration, sampling_rate);
+    DSG_PROFILE_COUNT(prof, data.size(), out.samples.size(), out.samples.capacity() * sizeof(float));
+    return out;
+}
+
+SampledSignalI8 DigitalSignalGenerator::encode_parallel_i8(LineCode code, const BitStream& data) const {
+    DSG_PROFILE_SCOPE(prof, "encode_parallel");
+    SampledSignalI8 out = parallel::encode_i8(code, data, bit_duration, sampling_rate);
+    DSG_PROFILE_COUNT(prof, data.size(), out.samples.size(), out.samples.capacity());
+    return out;
+}
+
+SampledSignal DigitalSignalGenerator::encode(LineCode code, const std::string& data) const {
+    return encode(code, BitStream(data));
+}
+
+static std::pair<std::vector<double>, std::vector<double>> with_time(SampledSignal&& s) {
+    std::vector<double> time = s.time_axis();
+    return {std::move(time), std::move(s.samples)};
 }
 
 std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::nrz_l(const std::string& data) const {
-    std::vector<double> time, signal;
-    int samples = sampling_rate;
-    for (size_t i=0;i<data.size();++i) {
-        double t0 = i * bit_duration;
-        double t1 = (i+1) * bit_duration;
-        double v = (data[i]=='1') ? 1.0 : -1.0;
-        append_samples(time, signal, t0, t1, samples, v);
-    }
-    return {time, signal};
+    return nrz_l(BitStream(data));
+}
+
+std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::nrz_l(const BitStream& data) const {
+    return with_time(encode(LineCode::NRZ_L, data));
 }
 
 std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::nrz_i(const std::string& data) const {
-    std::vector<double> time, signal;
-    int samples = sampling_rate;
-    double level = -1.0;
-    for (size_t i=0;i<data.size();++i) {
-        if (data[i]=='1') level = -level;
-        double t0 = i * bit_duration;
-        double t1 = (i+1) * bit_duration;
-        append_samples(time, signal, t0, t1, samples, level);
-    }
-    return {time, signal};
+    return nrz_i(BitStream(data));
+}
+
+std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::nrz_i(const BitStream& data) const {
+    return with_time(encode(LineCode::NRZ_I, data));
 }
 
 std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::manchester(const std::string& data) const {
-    std::vector<double> time, signal;
-    int half_samples = sampling_rate / 2;
-    for (size_t i=0;i<data.size();++i) {
-        double t0 = i * bit_duration;
-        double mid = t0 + bit_duration/2.0;
-        if (data[i]=='1') {
-            append_samples(time, signal, t0, mid, half_samples, -1.0);
-            append_samples(time, signal, mid, t0 + bit_duration, half_samples, 1.0);
-        } else {
-            append_samples(time, signal, t0, mid, half_samples, 1.0);
-            append_samples(time, signal, mid, t0 + bit_duration, half_samples, -1.0);
-        }
-    }
-    return {time, signal};
+    return manchester(BitStream(data));
+}
+
+std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::manchester(const BitStream& data) const {
+    return with_time(encode(LineCode::Manchester, data));
 }
 
 std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::differential_manchester(const std::string& data) const {
-    std::vector<double> time, signal;
-    int half_samples = sampling_rate / 2;
-    double level = 1.0;
-    for (size_t i=0;i<data.size();++i) {
-        double t0 = i * bit_duration;
-        double mid = t0 + bit_duration/2.0;
-        if (data[i]=='0') level = -level;
-        append_samples(time, signal, t0, mid, half_samples, level);
-        level = -level;
-        append_samples(time, signal, mid, t0 + bit_duration, half_samples, level);
-    }
-    return {time, signal};
+    return differential_manchester(BitStream(data));
+}
+
+std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::differential_manchester(const BitStream& data) const {
+    return with_time(encode(LineCode::DifferentialManchester, data));
 }
 
 std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::ami(const std::string& data) const {
-    std::vector<double> time, signal;
-    int samples = sampling_rate;
-    double last_one = -1.0;
-    for (size_t i=0;i<data.size();++i) {
-        double t0 = i * bit_duration;
-        double t1 = (i+1) * bit_duration;
-        double v = 0.0;
-        if (data[i] == '1') {
-            last_one = -last_one;
-            v = last_one;
-        }
-        append_samples(time, signal, t0, t1, samples, v);
-    }
-    return {time, signal};
+    return ami(BitStream(data));
 }
 
-// decoders (simple heuristics similar to python)
-std::string DigitalSignalGenerator::decode_nrz_l(const std::vector<double>& signal) const {
-    int samples_per_bit = sampling_rate;
-    std::string out;
-    for (size_t i=0;i+samples_per_bit<=signal.size(); i += samples_per_bit) {
-        double avg = std::accumulate(signal.begin()+i, signal.begin()+i+samples_per_bit, 0.0) / samples_per_bit;
-        out.push_back(avg > 0.0 ? '1' : '0');
-    }
+std::pair<std::vector<double>, std::vector<double>> DigitalSignalGenerator::ami(const BitStream& data) const {
+    return with_time(encode(LineCode::AMI, data));
+}
+
+// decoders (simple heuristics similar to python); whole-buffer decoding is one
+// StreamDecoder pass, which reduces the bit windows with the SIMD kernels
+template <class T>
+static void decode_all(LineCode code, const std::vector<T>& signal, int sampling_rate, BitStream& out) {
+    DSG_PROFILE_SCOPE(prof, "decode");
+    DSG_PROFILE_HEAP_BASE(prof, out.capacity() / 8);
+    BasicStreamDecoder<T> dec(code, sampling_rate);
+    out.clear();
+    out.reserve(signal.size() / sampling_rate);
+    dec.decode(signal.data(), signal.size(), out);
+    DSG_PROFILE_COUNT(prof, out.size(), signal.size(), out.capacity() / 8);
+}
+
+template <class T>
+static BitStream decode_all(LineCode code, const std::vector<T>& signal, int sampling_rate) {
+    BitStream out;
+    decode_all(code, signal, sampling_rate, out);
     return out;
 }
 
-std::string DigitalSignalGenerator::decode_nrz_i(const std::vector<double>& signal) const {
-    int s = sampling_rate;
-    std::string out;
-    if (signal.empty()) return out;
-    double last_level = signal[0];
-    for (size_t i=0;i+s<=signal.size(); i += s) {
-        double avg = std::accumulate(signal.begin()+i, signal.begin()+i+s, 0.0) / s;
-        char bit = (std::abs(avg - last_level) > 0.5) ? '1' : '0';
-        out.push_back(bit);
-        last_level = avg;
-    }
+BitStream DigitalSignalGenerator::decode(LineCode code, const std::vector<double>& signal) const {
+    return decode_all(code, signal, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode(LineCode code, const std::vector<float>& signal) const {
+    return decode_all(code, signal, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode(LineCode code, const std::vector<std::int8_t>& signal) const {
+    return decode_all(code, signal, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode(LineCode code, const RunLengthSignal& signal) const {
+    BitStream out;
+    decode(code, signal, out);
     return out;
 }
 
-std::string DigitalSignalGenerator::decode_manchester(const std::vector<double>& signal) const {
-    int s = sampling_rate;
-    std::string out;
-    for (size_t i=0;i+s<=signal.size(); i += s) {
-        int half = s/2;
-        double first = std::accumulate(signal.begin()+i, signal.begin()+i+half, 0.0) / half;
-        double second = std::accumulate(signal.begin()+i+half, signal.begin()+i+s, 0.0) / (s-half);
-        out.push_back(first < second ? '1' : '0');
-    }
+void DigitalSignalGenerator::decode(LineCode code, const std::vector<double>& signal, BitStream& out) const {
+    decode_all(code, signal, sampling_rate, out);
+}
+
+void DigitalSignalGenerator::decode(LineCode code, const std::vector<float>& signal, BitStream& out) const {
+    decode_all(code, signal, sampling_rate, out);
+}
+
+void DigitalSignalGenerator::decode(LineCode code, const std::vector<std::int8_t>& signal, BitStream& out) const {
+    decode_all(code, signal, sampling_rate, out);
+}
+
+void DigitalSignalGenerator::decode(LineCode code, const RunLengthSignal& signal, BitStream& out) const {
+    DSG_PROFILE_SCOPE(prof, "decode_runs");
+    DSG_PROFILE_HEAP_BASE(prof, out.capacity() / 8);
+    decode_runs(code, signal, sampling_rate, out);
+    DSG_PROFILE_COUNT(prof, out.size(), signal.count, out.capacity() / 8);
+}
+
+template <class T>
+static BitStream decode_parallel_profiled(LineCode code, const std::vector<T>& signal, int sampling_rate) {
+    DSG_PROFILE_SCOPE(prof, "decode_parallel");
+    BitStream out = parallel::decode(code, signal, sampling_rate);
+    DSG_PROFILE_COUNT(prof, out.size(), signal.size(), out.capacity() / 8);
     return out;
 }
 
-std::string DigitalSignalGenerator::decode_differential_manchester(const std::vector<double>& signal) const {
-    int s = sampling_rate;
-    std::string out;
-    for (size_t i=0;i+s<=signal.size(); i += s) {
-        int half = s/2;
-        double first = std::accumulate(signal.begin()+i, signal.begin()+i+half, 0.0) / half;
-        double second = std::accumulate(signal.begin()+i+half, signal.begin()+i+s, 0.0) / (s-half);
-        out.push_back(std::abs(first - second) > 0.5 ? '1' : '0');
-    }
+BitStream DigitalSignalGenerator::decode_parallel(LineCode code, const std::vector<double>& signal) const {
+    return decode_parallel_profiled(code, signal, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode_parallel(LineCode code, const std::vector<float>& signal) const {
+    return decode_parallel_profiled(code, signal, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode_parallel(LineCode code, const std::vector<std::int8_t>& signal) const {
+    return decode_parallel_profiled(code, signal, sampling_rate);
+}
+
+template <class T>
+static BasicSampledSignal<T> ami_scrambled_as(const BitStream& data, Scrambler scrambler, double bit_duration, int sampling_rate) {
+    size_t spb = (size_t)samples_per_bit(LineCode::AMI, sampling_rate);
+    if (spb == 0) throw std::invalid_argument("sampling_rate too small for line code");
+    DSG_PROFILE_SCOPE(prof, "encode_ami_scrambled");
+    std::vector<std::int8_t> symbols(data.size());
+    scramble_ami(data, scrambler, symbols.data());
+    BasicSampledSignal<T> out;
+    out.dt = bit_duration / spb;
+    out.samples.resize(data.size() * spb);
+    T* p = out.samples.data();
+    for (size_t i = 0; i < symbols.size(); ++i, p += spb) std::fill(p, p + spb, (T)symbols[i]);
+    DSG_PROFILE_COUNT(prof, data.size(), out.samples.size(), symbols.capacity() + out.samples.capacity() * sizeof(T));
     return out;
 }
 
-std::string DigitalSignalGenerator::decode_ami(const std::vector<double>& signal) const {
-    int s = sampling_rate;
-    std::string out;
-    for (size_t i=0;i+s<=signal.size(); i += s) {
-        double avg = std::accumulate(signal.begin()+i, signal.begin()+i+s, 0.0) / s;
-        out.push_back(std::abs(avg) > 0.1 ? '1' : '0');
+SampledSignal DigitalSignalGenerator::encode_ami_scrambled(const BitStream& data, Scrambler scrambler) const {
+    return ami_scrambled_as<double>(data, scrambler, bit_duration, sampling_rate);
+}
+
+SampledSignalI8 DigitalSignalGenerator::encode_ami_scrambled_i8(const BitStream& data, Scrambler scrambler) const {
+    return ami_scrambled_as<std::int8_t>(data, scrambler, bit_duration, sampling_rate);
+}
+
+RunLengthSignal DigitalSignalGenerator::encode_ami_scrambled_runs(const BitStream& data, Scrambler scrambler) const {
+    RunLengthSignal out;
+    encode_ami_scrambled_runs(data, scrambler, out);
+    return out;
+}
+
+void DigitalSignalGenerator::encode_ami_scrambled_runs(const BitStream& data, Scrambler scrambler, RunLengthSignal& out) const {
+    std::uint64_t spb = (std::uint64_t)samples_per_bit(LineCode::AMI, sampling_rate);
+    if (spb == 0) throw std::invalid_argument("sampling_rate too small for line code");
+    DSG_PROFILE_SCOPE(prof, "encode_ami_scrambled_runs");
+    DSG_PROFILE_HEAP_BASE(prof, out.memory_bytes());
+    out.clear();
+    out.t0 = 0.0;
+    out.dt = bit_duration / (double)spb;
+    // at most one run per symbol; symbols go through a fixed block instead of a whole-stream buffer
+    out.starts.reserve(data.size());
+    out.levels.reserve(data.size());
+    constexpr size_t block = 4096;
+    std::int8_t symbols[block + 8];
+    AmiScrambler enc(scrambler);
+    for (size_t first = 0; first < data.size(); first += block) {
+        size_t n = enc.push(data, first, std::min(block, data.size() - first), symbols);
+        for (size_t k = 0; k < n; ++k) out.push(symbols[k], spb);
     }
+    size_t n = enc.finish(symbols);
+    for (size_t k = 0; k < n; ++k) out.push(symbols[k], spb);
+    DSG_PROFILE_COUNT(prof, data.size(), out.count, out.memory_bytes());
+}
+
+template <class T>
+static BitStream decode_ami_scrambled_dense(const std::vector<T>& signal, Scrambler scrambler, int sampling_rate) {
+    if (sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+    DSG_PROFILE_SCOPE(prof, "decode_ami_scrambled");
+    size_t s = (size_t)sampling_rate;
+    size_t n = signal.size() / s;
+    std::vector<double> sums(n);
+    simd::segment_sums(signal.data(), n, s, 0, s, sums.data());
+    std::vector<std::int8_t> symbols(n);
+    ami_symbols(sums.data(), n, sampling_rate, symbols.data());
+    BitStream out = descramble_ami(symbols.data(), n, scrambler);
+    DSG_PROFILE_COUNT(prof, out.size(), n * (size_t)sampling_rate, sums.capacity() * sizeof(double) + symbols.capacity() + out.capacity() / 8);
     return out;
 }
 
+BitStream DigitalSignalGenerator::decode_ami_scrambled(const std::vector<double>& signal, Scrambler scrambler) const {
+    return decode_ami_scrambled_dense(signal, scrambler, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode_ami_scrambled(const std::vector<std::int8_t>& signal, Scrambler scrambler) const {
+    return decode_ami_scrambled_dense(signal, scrambler, sampling_rate);
+}
+
+BitStream DigitalSignalGenerator::decode_ami_scrambled(const RunLengthSignal& signal, Scrambler scrambler) const {
+    if (sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+    DSG_PROFILE_SCOPE(prof, "decode_ami_scrambled");
+    size_t n = (size_t)(signal.count / (std::uint64_t)sampling_rate);
+    std::vector<double> sums(n);
+    window_sums(signal, 0, (std::uint64_t)sampling_rate, n, sums.data());
+    std::vector<std::int8_t> symbols(n);
+    ami_symbols(sums.data(), n, sampling_rate, symbols.data());
+    BitStream out = descramble_ami(symbols.data(), n, scrambler);
+    DSG_PROFILE_COUNT(prof, out.size(), n * (size_t)sampling_rate, sums.capacity() * sizeof(double) + symbols.capacity() + out.capacity() / 8);
+    return out;
+}
+
+std::string DigitalSignalGenerator::decode_nrz_l(const std::vector<double>& signal) const {
+    return decode_nrz_l_bits(signal).to_string();
+}
+
+BitStream DigitalSignalGenerator::decode_nrz_l_bits(const std::vector<double>& signal) const {
+    return decode(LineCode::NRZ_L, signal);
+}
+
+std::string DigitalSignalGenerator::decode_nrz_i(const std::vector<double>& signal) const {
+    return decode_nrz_i_bits(signal).to_string();
+}
+
+BitStream DigitalSignalGenerator::decode_nrz_i_bits(const std::vector<double>& signal) const {
+    return decode(LineCode::NRZ_I, signal);
+}
+
+std::string DigitalSignalGenerator::decode_manchester(const std::vector<double>& signal) const {
+    return decode_manchester_bits(signal).to_string();
+}
+
+BitStream DigitalSignalGenerator::decode_manchester_bits(const std::vector<double>& signal) const {
+    return decode(LineCode::Manchester, signal);
+}
+
+std::string DigitalSignalGenerator::decode_differential_manchester(const std::vector<double>& signal) const {
+    return decode_differential_manchester_bits(signal).to_string();
+}
+
+BitStream DigitalSignalGenerator::decode_differential_manchester_bits(const std::vector<double>& signal) const {
+    return decode(LineCode::DifferentialManchester, signal);
+}
+
+std::string DigitalSignalGenerator::decode_ami(const std::vector<double>& signal) const {
+    return decode_ami_bits(signal).to_string();
+}
+
+BitStream DigitalSignalGenerator::decode_ami_bits(const std::vector<double>& signal) const {
+    return decode(LineCode::AMI, signal);
+}
+
 std::vector<std::pair<int,int>> DigitalSignalGenerator::find_zero_sequences(const std::string& data) const {
     std::vector<std::pair<int,int>> seq;
     size_t i = 0;
@@ -220,9 +453,18 @@ std::vector<std::pair<int,int>> DigitalSignalGenerator::find_zero_sequences(cons
     return seq;
 }
 
-std::string DigitalSignalGenerator::b8zs_scramble(const std::string& data) const {
-    std::string result = data;
-    auto sequences = find_zero_sequences(data);
+std::vector<std::pair<int,int>> DigitalSignalGenerator::find_zero_sequences(const BitStream& data) const {
+    std::vector<std::pair<int,int>> seq;
+    size_t i = data.find_next(0, false);
+    while (i < data.size()) {
+        size_t end = data.find_next(i, true);
+        seq.emplace_back((int)i, (int)(end - i));
+        i = data.find_next(end, false);
+    }
+    return seq;
+}
+
+static std::string apply_b8zs(std::string result, const std::vector<std::pair<int,int>>& sequences) {
     for (auto &p : sequences) {
         int start = p.first;
         int length = p.second;
@@ -238,22 +480,52 @@ std::string DigitalSignalGenerator::b8zs_scramble(const std::string& data) const
     return result;
 }
 
-std::string DigitalSignalGenerator::hdb3_scramble(const std::string& data) const {
-    std::string result = data;
-    auto sequences = find_zero_sequences(data);
-    int ones_count = 0;
+// pulses counts the marks sent since the last violation: odd -> 000V, even -> B00V
+static std::string apply_hdb3(std::string result, const std::vector<std::pair<int,int>>& sequences) {
+    size_t pulses = 0;
+    int prev_end = 0;
     for (auto &p : sequences) {
         int start = p.first;
         int length = p.second;
+        pulses += (size_t)(start - prev_end);   // everything between zero runs is a mark
+        prev_end = start + length;
         if (length >= 4) {
             for (int j = start; j <= start + length - 4; j += 4) {
                 if (j + 4 <= (int)result.size()) {
-                    if (ones_count % 2 == 0) result.replace(j, 4, "000V");
+                    if (pulses % 2 == 1) result.replace(j, 4, "000V");
                     else result.replace(j, 4, "B00V");
-                    ++ones_count;
+                    pulses = 0;
                 }
             }
         }
     }
     return result;
-}
\ No newline at end of file
+}
+
+std::string DigitalSignalGenerator::b8zs_scramble(const std::string& data) const {
+    DSG_PROFILE_SCOPE(prof, "b8zs_scramble");
+    std::string out = apply_b8zs(data, find_zero_sequences(data));
+    DSG_PROFILE_COUNT(prof, data.size(), 0, out.capacity());
+    return out;
+}
+
+std::string DigitalSignalGenerator::hdb3_scramble(const std::string& data) const {
+    DSG_PROFILE_SCOPE(prof, "hdb3_scramble");
+    std::string out = apply_hdb3(data, find_zero_sequences(data));
+    DSG_PROFILE_COUNT(prof, data.size(), 0, out.capacity());
+    return out;
+}
+
+std::string DigitalSignalGenerator::b8zs_scramble(const BitStream& data) const {
+    DSG_PROFILE_SCOPE(prof, "b8zs_scramble");
+    std::string out = apply_b8zs(data.to_string(), find_zero_sequences(data));
+    DSG_PROFILE_COUNT(prof, data.size(), 0, out.capacity());
+    return out;
+}
+
+std::string DigitalSignalGenerator::hdb3_scramble(const BitStream& data) const {
+    DSG_PROFILE_SCOPE(prof, "hdb3_scramble");
+    std::string out = apply_hdb3(data.to_string(), find_zero_sequences(data));
+    DSG_PROFILE_COUNT(prof, data.size(), 0, out.capacity());
+    return out;
+}
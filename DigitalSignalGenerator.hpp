@@ -1,4 +1,12 @@
 #pragma once
+#include "BitStream.hpp"
+#include "Companding.hpp"
+#include "LineCode.hpp"
+#include "RunLengthSignal.hpp"
+#include "SampledSignal.hpp"
+#include "Scrambler.hpp"
+#include "SourceCoding.hpp"
+#include "StreamingCodec.hpp"
 #include <vector>
 #include <string>
 #include <tuple>
@@ -10,9 +18,16 @@ public:
     // Encoders / decoders
     std::string pcm_encode(const std::vector<double>& analog_signal, int n_bits = 8) const;
     std::string delta_modulation(const std::vector<double>& analog_signal, double step_size = 0.1) const;
+    BitStream pcm_encode_bits(const std::vector<double>& analog_signal, int n_bits = 8) const;
+    BitStream delta_modulation_bits(const std::vector<double>& analog_signal, double step_size = 0.1) const;
+    // 8-bit G.711 companded PCM (mu-law / A-law), code words MSB first; peak |sample| maps to full scale
+    BitStream pcm_encode_companded(const std::vector<double>& analog_signal, Companding law) const;
+    std::vector<double> pcm_decode_companded(const BitStream& bits, Companding law, double peak = 1.0) const;
 
-    // Manacher
+    // Manacher; the BitStream version runs the packed search of Palindrome.hpp, with
+    // 64-bit start / length (streams up to 2^32 - 1 bits)
     std::tuple<std::string,int,int> longest_palindrome_manacher(const std::string& data_stream) const;
+    std::tuple<BitStream,std::uint64_t,std::uint64_t> longest_palindrome_manacher(const BitStream& data_stream) const;
 
     // Line encodings -> return pair<time, signal>
     std::pair<std::vector<double>, std::vector<double>> nrz_l(const std::string& data) const;
@@ -20,22 +35,81 @@ public:
     std::pair<std::vector<double>, std::vector<double>> manchester(const std::string& data) const;
     std::pair<std::vector<double>, std::vector<double>> differential_manchester(const std::string& data) const;
     std::pair<std::vector<double>, std::vector<double>> ami(const std::string& data) const;
+    std::pair<std::vector<double>, std::vector<double>> nrz_l(const BitStream& data) const;
+    std::pair<std::vector<double>, std::vector<double>> nrz_i(const BitStream& data) const;
+    std::pair<std::vector<double>, std::vector<double>> manchester(const BitStream& data) const;
+    std::pair<std::vector<double>, std::vector<double>> differential_manchester(const BitStream& data) const;
+    std::pair<std::vector<double>, std::vector<double>> ami(const BitStream& data) const;
+
+    // Line encoding with an implicit time axis (t0, dt, count) -> only samples are stored
+    SampledSignal encode(LineCode code, const BitStream& data) const;
+    SampledSignal encode(LineCode code, const std::string& data) const;
+    SampledSignalF encode_f32(LineCode code, const BitStream& data) const;
+    // int8 ternary samples (-1 / 0 / +1): an eighth of the double size; convert only
+    // where a float is needed (plotting, channel / DAC)
+    SampledSignalI8 encode_i8(LineCode code, const BitStream& data) const;
+    // Run-length (level, duration) waveform; expand or sample() lazily for dense samples
+    RunLengthSignal encode_runs(LineCode code, const BitStream& data) const;
+    // Into caller-owned outputs, sized exactly from the bit count and sampling_rate and
+    // reusing their capacity: repeated calls of the same size allocate nothing.
+    void encode(LineCode code, const BitStream& data, SampledSignal& out) const;
+    void encode(LineCode code, const BitStream& data, SampledSignalF& out) const;
+    void encode(LineCode code, const BitStream& data, SampledSignalI8& out) const;
+    void encode_runs(LineCode code, const BitStream& data, RunLengthSignal& out) const;
+    // Multi-core versions (ParallelCodec.hpp), bit-exact with encode / decode
+    SampledSignal encode_parallel(LineCode code, const BitStream& data) const;
+    SampledSignalF encode_parallel_f32(LineCode code, const BitStream& data) const;
+    SampledSignalI8 encode_parallel_i8(LineCode code, const BitStream& data) const;
 
     // Decoders
+    BitStream decode(LineCode code, const std::vector<double>& signal) const;
+    BitStream decode(LineCode code, const std::vector<float>& signal) const;
+    BitStream decode(LineCode code, const std::vector<std::int8_t>& signal) const;   // integer window sums
+    BitStream decode(LineCode code, const RunLengthSignal& signal) const;
+    // into a reused BitStream (cleared first)
+    void decode(LineCode code, const std::vector<double>& signal, BitStream& out) const;
+    void decode(LineCode code, const std::vector<float>& signal, BitStream& out) const;
+    void decode(LineCode code, const std::vector<std::int8_t>& signal, BitStream& out) const;
+    void decode(LineCode code, const RunLengthSignal& signal, BitStream& out) const;
+    BitStream decode_parallel(LineCode code, const std::vector<double>& signal) const;
+    BitStream decode_parallel(LineCode code, const std::vector<float>& signal) const;
+    BitStream decode_parallel(LineCode code, const std::vector<std::int8_t>& signal) const;
     std::string decode_nrz_l(const std::vector<double>& signal) const;
     std::string decode_nrz_i(const std::vector<double>& signal) const;
     std::string decode_manchester(const std::vector<double>& signal) const;
     std::string decode_differential_manchester(const std::vector<double>& signal) const;
     std::string decode_ami(const std::vector<double>& signal) const;
+    BitStream decode_nrz_l_bits(const std::vector<double>& signal) const;
+    BitStream decode_nrz_i_bits(const std::vector<double>& signal) const;
+    BitStream decode_manchester_bits(const std::vector<double>& signal) const;
+    BitStream decode_differential_manchester_bits(const std::vector<double>& signal) const;
+    BitStream decode_ami_bits(const std::vector<double>& signal) const;
+
+    // AMI with B8ZS / HDB3 zero substitution as real bipolar levels, and the matching
+    // descrambling decoders (Scrambler.hpp)
+    SampledSignal encode_ami_scrambled(const BitStream& data, Scrambler scrambler) const;
+    SampledSignalI8 encode_ami_scrambled_i8(const BitStream& data, Scrambler scrambler) const;
+    RunLengthSignal encode_ami_scrambled_runs(const BitStream& data, Scrambler scrambler) const;
+    void encode_ami_scrambled_runs(const BitStream& data, Scrambler scrambler, RunLengthSignal& out) const;
+    BitStream decode_ami_scrambled(const std::vector<double>& signal, Scrambler scrambler) const;
+    BitStream decode_ami_scrambled(const std::vector<std::int8_t>& signal, Scrambler scrambler) const;
+    BitStream decode_ami_scrambled(const RunLengthSignal& signal, Scrambler scrambler) const;
 
-    // Scrambling
+    // Scrambling (output keeps the 'V'/'B' placeholder symbols, so it stays a string)
     std::string b8zs_scramble(const std::string& data) const;
     std::string hdb3_scramble(const std::string& data) const;
+    std::string b8zs_scramble(const BitStream& data) const;
+    std::string hdb3_scramble(const BitStream& data) const;
+
+    // Chunked encoder / decoder objects for unbounded streams (state carried across calls)
+    StreamEncoder stream_encoder(LineCode code) const { return StreamEncoder(code, sampling_rate); }
+    StreamDecoder stream_decoder(LineCode code) const { return StreamDecoder(code, sampling_rate); }
 
     // Utilities
     std::vector<std::pair<int,int>> find_zero_sequences(const std::string& data) const;
+    std::vector<std::pair<int,int>> find_zero_sequences(const BitStream& data) const;
 
     // config
     double bit_duration;
     int sampling_rate;
-};
\ No newline at end of file
+};
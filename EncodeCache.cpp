@@ -0,0 +1,139 @@
+#include "EncodeCache.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+constexpr size_t progress_bits = size_t(1) << 16;
+
+// first bit where a and b differ, or the shorter length if one is a prefix of the other
+size_t common_prefix(const BitStream& a, const BitStream& b) {
+    size_t n = std::min(a.size(), b.size());
+    size_t words = (n + BitStream::word_bits - 1) / BitStream::word_bits;
+    for (size_t k = 0; k < words; ++k) {
+        BitStream::word_type diff = a.words()[k] ^ b.words()[k];
+        if (diff) return std::min(n, k * BitStream::word_bits + (size_t)ctz64(diff));
+    }
+    return n;
+}
+
+} // namespace
+
+EncodeCache::EncodeCache(size_t capacity, size_t checkpoint_bits)
+    : capacity_(std::max<size_t>(1, capacity)), checkpoint_bits_(std::max<size_t>(BitStream::word_bits, checkpoint_bits)) { }
+
+// 64-bit multiply-xorshift over the words and the length
+std::uint64_t EncodeCache::hash(const BitStream& data) {
+    std::uint64_t h = 0x9E3779B97F4A7C15ull ^ data.size();
+    for (size_t k = 0; k < data.word_count(); ++k) {
+        h ^= data.words()[k];
+        h *= 0xBF58476D1CE4E5B9ull;
+        h ^= h >> 31;
+    }
+    return h;
+}
+
+const RunLengthSignal& EncodeCache::encode(const BitStream& data, LineCode code, double bit_duration, int sampling_rate,
+                                           Scrambler scrambler, const std::function<void(double)>& progress) {
+    if (scrambler != Scrambler::None && code != LineCode::AMI) throw std::invalid_argument("scrambling needs AMI");
+    std::uint64_t spb = (std::uint64_t)samples_per_bit(code, sampling_rate);
+    if (spb == 0) throw std::invalid_argument("sampling_rate too small for line code");
+    std::uint64_t h = hash(data);
+    ++tick_;
+
+    // exact hit, else the same parameters with the longest common prefix
+    Entry* base = nullptr;
+    size_t prefix = 0;
+    for (Entry& e : entries_) {
+        if (e.code != code || e.bit_duration != bit_duration || e.sampling_rate != sampling_rate || e.scrambler != scrambler)
+            continue;
+        if (e.hash == h && e.data == data) {
+            e.used = tick_;
+            ++stats_.hits;
+            last_outcome_ = Outcome::Hit;
+            last_resume_bit_ = data.size();
+            return e.runs;
+        }
+        size_t p = common_prefix(e.data, data);
+        if (!base || p > prefix) { base = &e; prefix = p; }
+    }
+
+    // the last checkpoint at or before the first changed bit; resuming from bit 0 would
+    // save nothing, so such an input gets an entry of its own instead
+    std::vector<Checkpoint>::iterator resume;
+    if (base) {
+        resume = std::upper_bound(base->checkpoints.begin(), base->checkpoints.end(), prefix,
+                                  [](size_t bit, const Checkpoint& c) { return bit < c.bit; }) - 1;
+        if (resume->bit == 0) base = nullptr;
+    }
+    Entry* e = base;
+    Checkpoint start{0, 0, initial_level(code), AmiScrambler(scrambler)};
+    if (base) {
+        start = *resume;
+        base->checkpoints.erase(resume + 1, base->checkpoints.end());
+        base->runs.truncate(start.samples);
+        ++stats_.resumed;
+        last_outcome_ = Outcome::Resumed;
+    } else {
+        if (entries_.size() < capacity_) {
+            entries_.emplace_back();
+            e = &entries_.back();
+        } else {
+            e = &*std::min_element(entries_.begin(), entries_.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+        }
+        e->code = code;
+        e->bit_duration = bit_duration;
+        e->sampling_rate = sampling_rate;
+        e->scrambler = scrambler;
+        e->runs.clear();
+        e->runs.t0 = 0.0;
+        e->runs.dt = bit_duration / (double)spb;
+        e->checkpoints.clear();
+        ++stats_.encoded;
+        last_outcome_ = Outcome::Encoded;
+    }
+    e->hash = h;
+    e->used = tick_;
+    e->data = data;
+    last_resume_bit_ = start.bit;
+    try {
+        encode_from(*e, data, start, progress);
+    } catch (...) {
+        // its runs and checkpoints no longer describe any input
+        entries_.erase(entries_.begin() + (e - entries_.data()));
+        throw;
+    }
+    return e->runs;
+}
+
+// Encodes bits [start.bit, n) onto e.runs, recording a checkpoint at every multiple of
+// checkpoint_bits and at the end (before the scrambler flushes its held-back zeros).
+void EncodeCache::encode_from(Entry& e, const BitStream& data, Checkpoint start, const std::function<void(double)>& progress) {
+    DSG_PROFILE_SCOPE(prof, "encode_cached");
+    DSG_PROFILE_HEAP_BASE(prof, e.runs.memory_bytes());
+    std::uint64_t spb = (std::uint64_t)samples_per_bit(e.code, e.sampling_rate);
+    size_t n = data.size();
+    if (e.checkpoints.empty()) e.checkpoints.push_back(start);
+    double level = start.level;
+    AmiScrambler scrambler = start.scrambler;
+    std::vector<std::int8_t> symbols(e.scrambler != Scrambler::None ? checkpoint_bits_ + 8 : 0);
+    for (size_t bit = start.bit; bit < n;) {
+        size_t next = std::min(n, (bit / checkpoint_bits_ + 1) * checkpoint_bits_);
+        if (e.scrambler != Scrambler::None) {
+            size_t w = scrambler.push(data, bit, next - bit, symbols.data());
+            for (size_t k = 0; k < w; ++k) e.runs.push(symbols[k], spb);
+        } else {
+            append_runs(e.code, data, bit, next, spb, level, e.runs);
+        }
+        if (progress && next / progress_bits != bit / progress_bits) progress((double)(next - start.bit) / (double)(n - start.bit));
+        bit = next;
+        e.checkpoints.push_back({bit, e.runs.count, level, scrambler});
+    }
+    if (e.scrambler != Scrambler::None) {
+        size_t w = scrambler.finish(symbols.data());
+        for (size_t k = 0; k < w; ++k) e.runs.push(symbols[k], spb);
+    }
+    stats_.bits_encoded += n - start.bit;
+    DSG_PROFILE_COUNT(prof, n - start.bit, e.runs.count, e.runs.memory_bytes());
+}
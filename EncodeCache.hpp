@@ -0,0 +1,80 @@
+#pragma once
+#include "BitStream.hpp"
+#include "LineCode.hpp"
+#include "RunLengthSignal.hpp"
+#include "Scrambler.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Line-coding results for interactive editing, keyed by (hash of the input bits, code,
+// bit_duration, sampling_rate, scrambler). An input seen before under the same
+// parameters is a lookup. An edited input re-encodes only from the first bit that
+// differs from the closest cached input with the same parameters: the encoder state
+// (carried level, or the scrambler with its pending zero run) and the run / sample
+// counts are checkpointed every checkpoint_bits bits and at the end, the runs are cut
+// back to the checkpoint before the edit and encoding resumes there. That entry is
+// updated in place, so a sequence of edits keeps a single entry; an input sharing no
+// checkpoint with any entry is encoded into a new one (least recently used evicted).
+//
+// Not thread-safe: use from one thread at a time (the GUI worker).
+class EncodeCache {
+public:
+    enum class Outcome { Hit, Resumed, Encoded };
+
+    struct Stats {
+        std::uint64_t hits = 0;
+        std::uint64_t resumed = 0;
+        std::uint64_t encoded = 0;
+        std::uint64_t bits_encoded = 0;   // bits actually run through an encoder
+    };
+
+    explicit EncodeCache(size_t capacity = 8, size_t checkpoint_bits = 1024);
+
+    // Runs of data, exactly as encode_runs / DigitalSignalGenerator::encode_ami_scrambled_runs
+    // give them; valid until the next call. scrambler must be None unless code is AMI.
+    // progress(fraction) is called every 64 Ki encoded bits; an exception it throws
+    // (e.g. BackgroundJob::Cancelled) drops the half-encoded entry and is rethrown.
+    const RunLengthSignal& encode(const BitStream& data, LineCode code, double bit_duration, int sampling_rate,
+                                  Scrambler scrambler = Scrambler::None, const std::function<void(double)>& progress = {});
+
+    // what the last encode() did, and the bit it resumed encoding from
+    Outcome last_outcome() const { return last_outcome_; }
+    size_t last_resume_bit() const { return last_resume_bit_; }
+    const Stats& stats() const { return stats_; }
+    size_t size() const { return entries_.size(); }
+    void clear() { entries_.clear(); }
+
+    static std::uint64_t hash(const BitStream& data);
+
+private:
+    struct Checkpoint {
+        size_t bit;                 // bits [0, bit) are encoded
+        std::uint64_t samples;      // run samples written for them
+        double level;
+        AmiScrambler scrambler;     // state before any held-back zeros are flushed
+    };
+
+    struct Entry {
+        std::uint64_t hash = 0;
+        LineCode code = LineCode::NRZ_L;
+        double bit_duration = 0.0;
+        int sampling_rate = 0;
+        Scrambler scrambler = Scrambler::None;
+        BitStream data;
+        RunLengthSignal runs;
+        std::vector<Checkpoint> checkpoints;   // ascending bit, the first at bit 0
+        std::uint64_t used = 0;                // LRU tick
+    };
+
+    void encode_from(Entry& e, const BitStream& data, Checkpoint start, const std::function<void(double)>& progress);
+
+    size_t capacity_;
+    size_t checkpoint_bits_;
+    std::vector<Entry> entries_;
+    std::uint64_t tick_ = 0;
+    Outcome last_outcome_ = Outcome::Encoded;
+    size_t last_resume_bit_ = 0;
+    Stats stats_;
+};
@@ -0,0 +1,25 @@
+#pragma once
+
+enum class LineCode { NRZ_L, NRZ_I, Manchester, DifferentialManchester, AMI };
+
+// Samples produced per bit; Manchester variants emit two equal halves of sampling_rate/2.
+inline int samples_per_bit(LineCode code, int sampling_rate) {
+    if (code == LineCode::Manchester || code == LineCode::DifferentialManchester) return 2 * (sampling_rate / 2);
+    return sampling_rate;
+}
+
+// Level carried between bits (NRZ-I level, Diff Manchester level, AMI last mark); unused otherwise.
+inline double initial_level(LineCode code) {
+    return code == LineCode::DifferentialManchester ? 1.0 : -1.0;
+}
+
+inline const char* line_code_name(LineCode code) {
+    switch (code) {
+        case LineCode::NRZ_L: return "NRZ-L";
+        case LineCode::NRZ_I: return "NRZ-I";
+        case LineCode::Manchester: return "Manchester";
+        case LineCode::DifferentialManchester: return "Diff Manchester";
+        case LineCode::AMI: return "AMI";
+    }
+    return "";
+}
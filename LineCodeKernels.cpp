@@ -0,0 +1,83 @@
+#include "LineCodeKernels.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace kernels {
+
+namespace {
+
+// SPB == 0: samples per bit taken from the runtime argument
+template <LineCode C, size_t SPB, class T>
+void encode_kernel(const BitStream& bits, size_t first, size_t count, T* out, size_t spb_rt, double& level) {
+    const size_t spb = SPB ? SPB : spb_rt;
+    const size_t half = spb / 2;
+    double state = level;
+    for (size_t i = 0; i < count; i += BitStream::word_bits) {
+        BitStream::word_type w = bits.extract(first + i);
+        size_t n = std::min(BitStream::word_bits, count - i);
+        T* p = out + i * spb;
+        for (size_t k = 0; k < n; ++k, p += spb) {
+            double a, b;
+            Code<C>::levels((w >> k) & 1u, state, a, b);
+            if constexpr (Code<C>::split) {
+                std::fill(p, p + half, T(a));
+                std::fill(p + half, p + spb, T(b));
+            } else {
+                std::fill(p, p + spb, T(a));
+            }
+        }
+    }
+    level = state;
+}
+
+template <LineCode C>
+void decide_kernel(size_t s, const double* first, const double* second, size_t n, double& last_level, BitStream& out) {
+    double sd = (double)s, half = (double)(s / 2);
+    for (size_t k = 0; k < n; ++k)
+        out.push_back(Code<C>::decide(first[k], Code<C>::split ? second[k] : 0.0, sd, half, last_level));
+}
+
+// Samples-per-bit values with dedicated instantiations (Manchester codes always use even values).
+constexpr size_t specialized_spb[] = {2, 4, 8, 10, 16, 20, 32, 50, 64, 100};
+constexpr size_t n_specialized = sizeof(specialized_spb) / sizeof(specialized_spb[0]);
+
+template <class T, LineCode C, size_t... I>
+constexpr std::array<EncodeFn<T>, n_specialized + 1> code_row(std::index_sequence<I...>) {
+    return {{&encode_kernel<C, specialized_spb[I], T>..., &encode_kernel<C, 0, T>}};
+}
+
+template <class T>
+constexpr std::array<std::array<EncodeFn<T>, n_specialized + 1>, 5> encoder_table() {
+    auto seq = std::make_index_sequence<n_specialized>{};
+    return {{code_row<T, LineCode::NRZ_L>(seq), code_row<T, LineCode::NRZ_I>(seq), code_row<T, LineCode::Manchester>(seq),
+             code_row<T, LineCode::DifferentialManchester>(seq), code_row<T, LineCode::AMI>(seq)}};
+}
+
+// rows follow the LineCode enumerator order
+template <class T>
+constexpr auto encoders = encoder_table<T>();
+
+constexpr DecideFn deciders[] = {&decide_kernel<LineCode::NRZ_L>, &decide_kernel<LineCode::NRZ_I>,
+                                 &decide_kernel<LineCode::Manchester>, &decide_kernel<LineCode::DifferentialManchester>,
+                                 &decide_kernel<LineCode::AMI>};
+
+} // namespace
+
+template <class T>
+EncodeFn<T> select_encoder(LineCode code, size_t spb) {
+    const auto& row = encoders<T>[(size_t)code];
+    for (size_t i = 0; i < n_specialized; ++i)
+        if (specialized_spb[i] == spb) return row[i];
+    return row[n_specialized];
+}
+
+template EncodeFn<double> select_encoder<double>(LineCode, size_t);
+template EncodeFn<float> select_encoder<float>(LineCode, size_t);
+template EncodeFn<std::int8_t> select_encoder<std::int8_t>(LineCode, size_t);
+
+DecideFn select_decider(LineCode code) {
+    return deciders[(size_t)code];
+}
+
+} // namespace kernels
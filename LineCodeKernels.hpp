@@ -0,0 +1,88 @@
+#pragma once
+#include "BitStream.hpp"
+#include "LineCode.hpp"
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// Compile-time line code policies and the specialized encode / decide kernels built
+// from them. Each kernel is instantiated per code (and, for the encoder, per common
+// samples-per-bit value) so the per-bit loop has no code switch and fixed-length
+// fills unroll; select_* picks the instantiation at runtime.
+namespace kernels {
+
+// Policy: levels(bit, state, a, b) gives the first / second half levels of a bit and
+// advances the carried state; decide(first, second, s, half, last) is the decoder
+// heuristic on window sums (second / half only used when split).
+template <LineCode C> struct Code;
+
+template <> struct Code<LineCode::NRZ_L> {
+    static constexpr bool split = false;
+    static void levels(bool bit, double&, double& a, double& b) { a = b = bit ? 1.0 : -1.0; }
+    static bool decide(double first, double, double s, double, double&) { return first / s > 0.0; }
+};
+
+template <> struct Code<LineCode::NRZ_I> {
+    static constexpr bool split = false;
+    static void levels(bool bit, double& state, double& a, double& b) {
+        if (bit) state = -state;
+        a = b = state;
+    }
+    static bool decide(double first, double, double s, double, double& last) {
+        double avg = first / s;
+        bool bit = std::abs(avg - last) > 0.5;
+        last = avg;
+        return bit;
+    }
+};
+
+template <> struct Code<LineCode::Manchester> {
+    static constexpr bool split = true;
+    static void levels(bool bit, double&, double& a, double& b) {
+        a = bit ? -1.0 : 1.0;
+        b = -a;
+    }
+    static bool decide(double first, double second, double s, double half, double&) {
+        return first / half < second / (s - half);
+    }
+};
+
+template <> struct Code<LineCode::DifferentialManchester> {
+    static constexpr bool split = true;
+    static void levels(bool bit, double& state, double& a, double& b) {
+        if (!bit) state = -state;
+        a = state;
+        state = -state;
+        b = state;
+    }
+    // 1 = no transition at the bit start: the first half keeps the previous second half's sign
+    static bool decide(double first, double second, double s, double half, double& last) {
+        bool bit = (first > 0.0) == (last > 0.0);
+        last = second / (s - half);
+        return bit;
+    }
+};
+
+template <> struct Code<LineCode::AMI> {
+    static constexpr bool split = false;
+    static void levels(bool bit, double& state, double& a, double& b) {
+        a = b = 0.0;
+        if (bit) { state = -state; a = b = state; }
+    }
+    static bool decide(double first, double, double s, double, double&) { return std::abs(first / s) > 0.1; }
+};
+
+// Writes count * spb samples for bits [first, first+count) and updates the carried level.
+template <class T>
+using EncodeFn = void (*)(const BitStream& bits, size_t first, size_t count, T* out, size_t spb, double& level);
+
+// Appends n decided bits from window sums (see decide_bits in StreamingCodec.hpp).
+using DecideFn = void (*)(size_t s, const double* first, const double* second, size_t n, double& last_level, BitStream& out);
+
+// Instantiation for (code, spb): specialized when spb is one of the precompiled
+// values, otherwise the generic runtime-spb kernel for the code.
+// Instantiated for double, float and int8 (the levels are exactly -1, 0, +1).
+template <class T> EncodeFn<T> select_encoder(LineCode code, size_t spb);
+DecideFn select_decider(LineCode code);
+
+} // namespace kernels
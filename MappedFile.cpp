@@ -0,0 +1,119 @@
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& path) {
+    HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                           FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (f == INVALID_HANDLE_VALUE) throw std::runtime_error("cannot open " + path);
+    LARGE_INTEGER size;
+    GetFileSizeEx(f, &size);
+    file_ = f;
+    size_ = (size_t)size.QuadPart;
+    if (size_ == 0) return;
+    mapping_ = CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping_) { CloseHandle(f); throw std::runtime_error("cannot map " + path); }
+    data_ = (const unsigned char*)MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+    if (!data_) { CloseHandle(mapping_); CloseHandle(f); throw std::runtime_error("cannot map " + path); }
+}
+
+MappedFile::~MappedFile() {
+    if (data_) UnmapViewOfFile(data_);
+    if (mapping_) CloseHandle(mapping_);
+    if (file_) CloseHandle(file_);
+}
+
+void MappedFile::release(size_t, size_t) const { }
+#else
+MappedFile::MappedFile(const std::string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) throw std::runtime_error("cannot open " + path);
+    struct stat st;
+    if (fstat(fd, &st) != 0) { ::close(fd); throw std::runtime_error("cannot stat " + path); }
+    size_ = (size_t)st.st_size;
+    if (size_ > 0) {
+        void* p = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { ::close(fd); throw std::runtime_error("cannot map " + path); }
+        madvise(p, size_, MADV_SEQUENTIAL);
+        data_ = (const unsigned char*)p;
+    }
+    ::close(fd);   // the mapping keeps the file referenced
+}
+
+MappedFile::~MappedFile() {
+    if (data_) munmap((void*)data_, size_);
+}
+
+void MappedFile::release(size_t offset, size_t len) const {
+    if (!data_) return;
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t begin = offset / page * page;
+    size_t end = std::min(size_, offset + len) / page * page;
+    if (end > begin) madvise((void*)(data_ + begin), end - begin, MADV_DONTNEED);
+}
+#endif
+
+BufferedWriter::BufferedWriter(const std::string& path, size_t buffer_bytes) : capacity_(buffer_bytes) {
+    f_ = std::fopen(path.c_str(), "wb");
+    if (!f_) throw std::runtime_error("cannot create " + path);
+    std::setvbuf(f_, nullptr, _IONBF, 0);   // our buffer is the only one
+    buf_.reserve(capacity_);
+}
+
+BufferedWriter::~BufferedWriter() {
+    try { close(); } catch (...) { }
+}
+
+void BufferedWriter::write(const void* data, size_t n) {
+    const unsigned char* p = (const unsigned char*)data;
+    if (buf_.size() + n > capacity_) {
+        flush();
+        if (n >= capacity_) {
+            if (std::fwrite(p, 1, n, f_) != n) throw std::runtime_error("write failed");
+            written_ += n;
+            return;
+        }
+    }
+    buf_.insert(buf_.end(), p, p + n);
+}
+
+void BufferedWriter::flush() {
+    if (!f_ || buf_.empty()) return;
+    if (std::fwrite(buf_.data(), 1, buf_.size(), f_) != buf_.size()) throw std::runtime_error("write failed");
+    written_ += buf_.size();
+    buf_.clear();
+}
+
+// 64-bit offsets: fseek takes a long, which is 32 bits on Win32
+static int seek_to(std::FILE* f, std::uint64_t offset) {
+#if defined(_WIN32)
+    return _fseeki64(f, (__int64)offset, SEEK_SET);
+#else
+    return fseeko(f, (off_t)offset, SEEK_SET);
+#endif
+}
+
+void BufferedWriter::write_at(std::uint64_t offset, const void* data, size_t n) {
+    flush();
+    if (seek_to(f_, offset) != 0 || std::fwrite(data, 1, n, f_) != n ||
+        std::fseek(f_, 0, SEEK_END) != 0)
+        throw std::runtime_error("write failed");
+}
+
+void BufferedWriter::close() {
+    if (!f_) return;
+    flush();
+    std::FILE* f = f_;
+    f_ = nullptr;
+    if (std::fclose(f) != 0) throw std::runtime_error("close failed");
+}
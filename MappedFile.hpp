@@ -0,0 +1,57 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// Read-only memory map of a whole file (POSIX mmap / Win32 file mapping). Pages are
+// faulted in on demand, so multi-gigabyte captures are read without copying.
+// Errors throw std::runtime_error.
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    const unsigned char* data() const { return data_; }
+    size_t size() const { return size_; }
+
+    // Hints that [offset, offset+len) has been consumed and may be dropped from memory.
+    void release(size_t offset, size_t len) const;
+
+private:
+    const unsigned char* data_ = nullptr;
+    size_t size_ = 0;
+#if defined(_WIN32)
+    void* file_ = nullptr;
+    void* mapping_ = nullptr;
+#endif
+};
+
+// Output file written through a large user-space buffer (one write call per
+// buffer_bytes), with positioned overwrite for headers patched at the end.
+class BufferedWriter {
+public:
+    explicit BufferedWriter(const std::string& path, size_t buffer_bytes = size_t(8) << 20);
+    ~BufferedWriter();
+
+    BufferedWriter(const BufferedWriter&) = delete;
+    BufferedWriter& operator=(const BufferedWriter&) = delete;
+
+    void write(const void* data, size_t n);
+    // flushes, then overwrites n bytes at offset (which must already have been written)
+    void write_at(std::uint64_t offset, const void* data, size_t n);
+    void flush();
+    void close();
+
+    std::uint64_t bytes_written() const { return written_ + buf_.size(); }
+
+private:
+    std::FILE* f_ = nullptr;
+    std::vector<unsigned char> buf_;
+    size_t capacity_;
+    std::uint64_t written_ = 0;
+};
@@ -0,0 +1,119 @@
+#include "MinMaxPyramid.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <cmath>
+
+void MinMaxPyramid::clear() {
+    lo_.clear();
+    hi_.clear();
+    count_ = 0;
+}
+
+size_t MinMaxPyramid::memory_bytes() const {
+    size_t bytes = 0;
+    for (size_t k = 0; k < lo_.size(); ++k) bytes += (lo_[k].size() + hi_[k].size()) * sizeof(std::int8_t);
+    return bytes;
+}
+
+// Level k gets ceil(base_buckets / 2^k) entries, down to a single bucket; the inner
+// arrays keep their capacity from earlier builds.
+void MinMaxPyramid::size_levels(size_t base_buckets) {
+    size_t levels = 1;
+    for (size_t n = base_buckets; n > 1; n = (n + 1) / 2) ++levels;
+    lo_.resize(levels);
+    hi_.resize(levels);
+    for (size_t k = 0, n = base_buckets; k < levels; ++k, n = (n + 1) / 2) {
+        lo_[k].resize(n);
+        hi_[k].resize(n);
+    }
+}
+
+// Level 0 straight from the runs: O(runs + buckets), no dense samples.
+void MinMaxPyramid::build(const RunLengthSignal& signal) {
+    DSG_PROFILE_SCOPE(prof, "plot_pyramid");
+    DSG_PROFILE_HEAP_BASE(prof, memory_bytes());
+    count_ = signal.count;
+    t0_ = signal.t0;
+    dt_ = signal.dt;
+    scale_ = 1.0;
+    if (count_ == 0) { clear(); return; }
+    size_t buckets = (size_t)((count_ + base_bucket - 1) / base_bucket);
+    size_levels(buckets);
+    size_t r = 0;
+    for (size_t b = 0; b < buckets; ++b) {
+        std::uint64_t a = b * base_bucket, e = std::min(count_, a + base_bucket);
+        while (a >= signal.starts[r] + signal.run_length(r)) ++r;
+        std::int8_t mn = signal.levels[r], mx = mn;
+        for (size_t k = r + 1; k < signal.starts.size() && signal.starts[k] < e; ++k) {
+            mn = std::min(mn, signal.levels[k]);
+            mx = std::max(mx, signal.levels[k]);
+        }
+        lo_[0][b] = mn;
+        hi_[0][b] = mx;
+    }
+    build_upper_levels();
+    DSG_PROFILE_COUNT(prof, 0, count_, memory_bytes());
+}
+
+void MinMaxPyramid::build(const float* samples, std::uint64_t n, double t0, double dt) {
+    DSG_PROFILE_SCOPE(prof, "plot_pyramid");
+    DSG_PROFILE_HEAP_BASE(prof, memory_bytes());
+    count_ = n;
+    t0_ = t0;
+    dt_ = dt;
+    if (n == 0) { clear(); return; }
+    size_t buckets = (size_t)((n + base_bucket - 1) / base_bucket);
+    size_levels(buckets);
+    auto [lowest, highest] = std::minmax_element(samples, samples + n);
+    double peak = std::max(std::abs((double)*lowest), std::abs((double)*highest));
+    scale_ = peak > 0.0 ? peak / 127.0 : 1.0;
+    auto code = [](double v) { return (std::int8_t)std::max(-127.0, std::min(127.0, v)); };
+    for (size_t b = 0; b < buckets; ++b) {
+        const float* p = samples + b * base_bucket;
+        const float* e = samples + std::min(n, (b + 1) * base_bucket);
+        auto [mn, mx] = std::minmax_element(p, e);
+        lo_[0][b] = code(std::floor(*mn / scale_));
+        hi_[0][b] = code(std::ceil(*mx / scale_));
+    }
+    build_upper_levels();
+    DSG_PROFILE_COUNT(prof, 0, count_, memory_bytes());
+}
+
+void MinMaxPyramid::build_upper_levels() {
+    for (size_t k = 1; k < lo_.size(); ++k) {
+        const auto& lo = lo_[k - 1];
+        const auto& hi = hi_[k - 1];
+        auto& nlo = lo_[k];
+        auto& nhi = hi_[k];
+        for (size_t i = 0; i < nlo.size(); ++i) {
+            size_t j = std::min(2 * i + 1, lo.size() - 1);
+            nlo[i] = std::min(lo[2 * i], lo[j]);
+            nhi[i] = std::max(hi[2 * i], hi[j]);
+        }
+    }
+}
+
+bool MinMaxPyramid::decimate(std::uint64_t first, std::uint64_t last, size_t max_pairs,
+                             std::vector<double>& xs, std::vector<double>& ys) const {
+    xs.clear();
+    ys.clear();
+    last = std::min(last, count_);
+    if (empty() || first >= last || max_pairs == 0) return false;
+    std::uint64_t span = last - first;
+    if (span < (std::uint64_t)max_pairs * base_bucket) return false;
+    size_t level = 0;
+    auto buckets = [&](size_t k) { return (last - 1) / bucket_size(k) - first / bucket_size(k) + 1; };
+    while (level + 1 < lo_.size() && buckets(level) > max_pairs) ++level;
+    std::uint64_t size = bucket_size(level);
+    size_t b0 = (size_t)(first / size), b1 = (size_t)((last - 1) / size) + 1;
+    xs.reserve(2 * (b1 - b0));
+    ys.reserve(2 * (b1 - b0));
+    for (size_t b = b0; b < b1; ++b) {
+        double t = t0_ + (double)(b * size) * dt_;
+        xs.push_back(t);
+        ys.push_back(lo_[level][b] * scale_);
+        xs.push_back(t);
+        ys.push_back(hi_[level][b] * scale_);
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "RunLengthSignal.hpp"
+#include <cstdint>
+#include <vector>
+
+// Min/max level-of-detail pyramid for drawing long signals. Level k holds the
+// minimum and maximum of every bucket of base_bucket << k samples; it is built once
+// per signal, and a view is then drawn with about one min/max pair per pixel no
+// matter how many samples it spans. Rebuilding reuses the level arrays, so a signal
+// no longer than the previous one is built without allocating. Levels are kept as
+// int8 and scaled to double only in decimate(): run levels exactly, float samples in
+// steps of 1/127 of their peak (minima rounded down, maxima up, so the envelope still
+// covers every sample).
+class MinMaxPyramid {
+public:
+    static constexpr std::uint64_t base_bucket = 64;
+
+    void build(const RunLengthSignal& signal);
+    void build(const float* samples, std::uint64_t n, double t0, double dt);
+    void clear();
+
+    bool empty() const { return lo_.empty(); }
+    size_t level_count() const { return lo_.size(); }
+    std::uint64_t bucket_size(size_t level) const { return base_bucket << level; }
+    size_t memory_bytes() const;
+
+    // Envelope of samples [first, last) as (time, level) points, two per bucket, at the
+    // finest level with no more than max_pairs buckets in the range. Returns false when
+    // even the finest level is too coarse (span < max_pairs * base_bucket): the caller
+    // should draw the raw samples, which are then few enough.
+    bool decimate(std::uint64_t first, std::uint64_t last, size_t max_pairs,
+                  std::vector<double>& xs, std::vector<double>& ys) const;
+
+private:
+    void size_levels(size_t base_buckets);
+    void build_upper_levels();
+
+    std::vector<std::vector<std::int8_t>> lo_, hi_;
+    double scale_ = 1.0;        // level of a stored value of 1
+    std::uint64_t count_ = 0;
+    double t0_ = 0.0;
+    double dt_ = 1.0;
+};
@@ -0,0 +1,95 @@
+#include "Palindrome.hpp"
+#include "Profiler.hpp"
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+using W = BitStream::word_type;
+constexpr std::uint64_t max_bits = std::numeric_limits<std::uint32_t>::max();
+constexpr size_t progress_mask = (size_t(1) << 20) - 1;
+
+// out[j] = s[n - 1 - j], a word at a time
+void reverse_into(const BitStream& s, BitStream& out) {
+    size_t n = s.size();
+    out.resize(n);
+    W* w = out.words();
+    for (size_t k = 0; k < out.word_count(); ++k) {
+        size_t end = n - k * BitStream::word_bits;   // bits s[end - 64, end) reversed
+        w[k] = end >= BitStream::word_bits ? reverse_bits64(s.extract(end - BitStream::word_bits))
+                                           : reverse_bits64(s.extract(0) << (BitStream::word_bits - end));
+    }
+}
+
+// Largest k <= limit with s[hi + j] == s[lo - 1 - j] for all j < k; rev[n - lo + j] is
+// s[lo - 1 - j], so both sides are plain 64-bit extracts. limit <= min(lo, n - hi).
+size_t match_outward(const BitStream& s, const BitStream& rev, size_t lo, size_t hi, size_t limit) {
+    size_t n = s.size();
+    for (size_t k = 0; k < limit; k += BitStream::word_bits) {
+        W diff = s.extract(hi + k) ^ rev.extract(n - lo + k);
+        if (diff) return std::min(limit, k + (size_t)ctz64(diff));
+    }
+    return limit;
+}
+
+// Manacher over the virtual string #b0#b1#...#b(n-1)#: centre i (0 <= i <= 2n) has radius
+// radii[i], the length of the palindrome of bits [(i - r) / 2, (i + r) / 2) around it.
+Palindrome manacher(const BitStream& s, const BitStream& rev, std::vector<std::uint32_t>& radii,
+                    const std::function<void(double)>& progress = {}) {
+    size_t n = s.size();
+    size_t m = 2 * n + 1;
+    radii.resize(m);   // every entry is written before its mirror reads it
+    size_t c = 0, right = 0;
+    Palindrome best;
+    for (size_t i = 0; i < m; ++i) {
+        if (progress && i && (i & progress_mask) == 0) progress((double)i / (double)m);
+        size_t r = i < right ? std::min<size_t>(right - i, radii[2 * c - i]) : (i & 1);
+        if (i + r >= right) {
+            size_t lo = (i - r) / 2, hi = (i + r) / 2;
+            r += 2 * match_outward(s, rev, lo, hi, std::min(lo, n - hi));
+            if (i + r > right) { c = i; right = i + r; }
+        }
+        radii[i] = (std::uint32_t)r;
+        if (r > best.length) best = {(i - r) / 2, r};
+    }
+    return best;
+}
+
+} // namespace
+
+Palindrome longest_palindrome(const BitStream& bits, const std::function<void(double)>& progress) {
+    if (bits.size() > max_bits) throw std::invalid_argument("bit stream too long for 32-bit radii; use PalindromeScanner");
+    DSG_PROFILE_SCOPE(prof, "longest_palindrome_manacher");
+    BitStream rev;
+    std::vector<std::uint32_t> radii;
+    reverse_into(bits, rev);
+    Palindrome p = manacher(bits, rev, radii, progress);
+    DSG_PROFILE_COUNT(prof, bits.size(), 0, radii.capacity() * sizeof(std::uint32_t) + rev.capacity() / 8);
+    return p;
+}
+
+PalindromeScanner::PalindromeScanner(std::uint64_t max_length) : max_length_(max_length) {
+    if (max_length == 0) throw std::invalid_argument("max_length must be positive");
+}
+
+void PalindromeScanner::push(const BitStream& chunk) {
+    if (chunk.empty()) return;
+    if (window_.size() + chunk.size() > max_bits) throw std::invalid_argument("chunk too long for 32-bit radii");
+    DSG_PROFILE_SCOPE(prof, "palindrome_chunk");
+    DSG_PROFILE_HEAP_BASE(prof, radii_.capacity() * sizeof(std::uint32_t) + (window_.capacity() + reversed_.capacity()) / 8);
+    window_.append(chunk);
+    reverse_into(window_, reversed_);
+    Palindrome p = manacher(window_, reversed_, radii_);
+    if (p.length > best_.length) {
+        best_ = {window_start_ + p.start, p.length};
+        best_bits_ = window_.substr((size_t)p.start, (size_t)p.length);
+    }
+    DSG_PROFILE_COUNT(prof, chunk.size(), 0, radii_.capacity() * sizeof(std::uint32_t) + (window_.capacity() + reversed_.capacity()) / 8);
+    // carry the bits a palindrome of up to max_length bits ending in the next chunk may need
+    size_t keep = (size_t)std::min<std::uint64_t>(max_length_ - 1, window_.size());
+    BitStream tail = window_.substr(window_.size() - keep, keep);
+    window_start_ += window_.size() - keep;
+    window_.clear();
+    window_.append(tail);
+}
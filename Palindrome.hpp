@@ -0,0 +1,46 @@
+#pragma once
+#include "BitStream.hpp"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Longest palindromic run of bits, found with Manacher's algorithm directly on the
+// packed stream: no separator-interleaved copy, 32-bit radii (4 bytes per centre, two
+// centres per bit) and palindromes extended 64 bits per compare against a reversed
+// copy of the stream (one bit per bit).
+struct Palindrome {
+    std::uint64_t start = 0;
+    std::uint64_t length = 0;   // 0 for an empty input
+};
+
+// Earliest of the longest palindromes. Streams longer than 2^32 - 1 bits throw
+// std::invalid_argument; scan those with PalindromeScanner. progress(fraction) is
+// called every 2^20 centres; an exception it throws (e.g. BackgroundJob::Cancelled)
+// abandons the search.
+Palindrome longest_palindrome(const BitStream& bits, const std::function<void(double)>& progress = {});
+
+// Chunked search over a stream that is never held in memory as a whole: each push
+// rescans the last max_length - 1 bits together with the new chunk, so memory is about
+// 9 bytes per bit of (max_length + chunk). The result is exact (position and tie-break
+// included) when the longest palindrome has at most max_length bits; a longer one is
+// reported as a palindrome of at least max_length - 1 bits.
+class PalindromeScanner {
+public:
+    explicit PalindromeScanner(std::uint64_t max_length);   // max_length >= 1
+
+    void push(const BitStream& chunk);
+    // start is an offset into the whole stream pushed so far
+    const Palindrome& result() const { return best_; }
+    // the bits of result()
+    const BitStream& result_bits() const { return best_bits_; }
+    std::uint64_t bits_seen() const { return window_start_ + window_.size(); }
+
+private:
+    std::uint64_t max_length_;
+    BitStream window_;                  // carried tail + current chunk
+    std::uint64_t window_start_ = 0;    // stream offset of window_[0]
+    BitStream reversed_;
+    std::vector<std::uint32_t> radii_;
+    Palindrome best_;
+    BitStream best_bits_;
+};
@@ -0,0 +1,110 @@
+#include "ParallelCodec.hpp"
+#include "SimdKernels.hpp"
+#include "StreamingCodec.hpp"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace parallel {
+
+namespace {
+
+// Chunks are whole 64-bit words so decoded chunks can be copied word-wise.
+constexpr size_t min_chunk_bits = 64 * 1024;
+
+size_t chunk_bits(size_t bits, const ThreadPool& pool) {
+    size_t target = (bits + pool.concurrency() * 4 - 1) / (pool.concurrency() * 4);
+    size_t chunk = std::max(min_chunk_bits, target);
+    return (chunk + BitStream::word_bits - 1) / BitStream::word_bits * BitStream::word_bits;
+}
+
+template <class T>
+BasicSampledSignal<T> encode_impl(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, ThreadPool& pool) {
+    if (sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+    StreamEncoder probe(code, sampling_rate);
+    size_t spb = (size_t)probe.samples_per_bit();
+    BasicSampledSignal<T> out;
+    out.dt = bit_duration / spb;
+    out.samples.resize(data.size() * spb);
+
+    size_t chunk = chunk_bits(data.size(), pool);
+    size_t chunks = (data.size() + chunk - 1) / chunk;
+
+    // prefix scan: parity of ones before each chunk gives its starting level
+    std::vector<size_t> ones(chunks);
+    pool.parallel_for(chunks, [&](size_t c) {
+        ones[c] = data.count(c * chunk, std::min(data.size(), (c + 1) * chunk));
+    });
+    std::vector<double> start_level(chunks);
+    size_t parity = 0;
+    for (size_t c = 0; c < chunks; ++c) {
+        start_level[c] = (parity & 1) ? -initial_level(code) : initial_level(code);
+        parity += ones[c];
+    }
+
+    pool.parallel_for(chunks, [&](size_t c) {
+        size_t first = c * chunk;
+        size_t n = std::min(data.size() - first, chunk);
+        StreamEncoder enc(code, sampling_rate);
+        enc.set_level(start_level[c]);
+        enc.encode(data, first, n, out.samples.data() + first * spb, n * spb);
+    });
+    return out;
+}
+
+template <class T>
+BitStream decode_impl(LineCode code, const std::vector<T>& signal, int sampling_rate, ThreadPool& pool) {
+    if (sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+    BitStream out;
+    size_t s = (size_t)sampling_rate;
+    size_t bits = signal.size() / s;
+    if (signal.empty()) return out;
+    out.resize(bits);
+
+    size_t chunk = chunk_bits(bits, pool);
+    size_t chunks = (bits + chunk - 1) / chunk;
+    pool.parallel_for(chunks, [&](size_t c) {
+        size_t first = c * chunk;
+        size_t n = std::min(bits - first, chunk);
+        BasicStreamDecoder<T> dec(code, sampling_rate);
+        // NRZ-I compares against the previous window's average, Diff Manchester against
+        // its second half; chunk 0 uses the batch decoder's default
+        if (c == 0) dec.set_reference_level(reference_level(code, signal[0]));
+        else if (code == LineCode::DifferentialManchester)
+            dec.set_reference_level(simd::sum(signal.data() + (first - 1) * s + s / 2, s - s / 2) / (double)(s - s / 2));
+        else dec.set_reference_level(simd::sum(signal.data() + (first - 1) * s, s) / s);
+        BitStream part;
+        part.reserve(n);
+        dec.decode(signal.data() + first * s, n * s, part);
+        std::memcpy(out.words() + first / BitStream::word_bits, part.words(), part.word_count() * sizeof(BitStream::word_type));
+    });
+    return out;
+}
+
+} // namespace
+
+SampledSignal encode(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, ThreadPool& pool) {
+    return encode_impl<double>(code, data, bit_duration, sampling_rate, pool);
+}
+
+SampledSignalF encode_f32(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, ThreadPool& pool) {
+    return encode_impl<float>(code, data, bit_duration, sampling_rate, pool);
+}
+
+SampledSignalI8 encode_i8(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, ThreadPool& pool) {
+    return encode_impl<std::int8_t>(code, data, bit_duration, sampling_rate, pool);
+}
+
+BitStream decode(LineCode code, const std::vector<double>& signal, int sampling_rate, ThreadPool& pool) {
+    return decode_impl(code, signal, sampling_rate, pool);
+}
+
+BitStream decode(LineCode code, const std::vector<float>& signal, int sampling_rate, ThreadPool& pool) {
+    return decode_impl(code, signal, sampling_rate, pool);
+}
+
+BitStream decode(LineCode code, const std::vector<std::int8_t>& signal, int sampling_rate, ThreadPool& pool) {
+    return decode_impl(code, signal, sampling_rate, pool);
+}
+
+} // namespace parallel
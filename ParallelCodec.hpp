@@ -0,0 +1,30 @@
+#pragma once
+#include "BitStream.hpp"
+#include "LineCode.hpp"
+#include "SampledSignal.hpp"
+#include "ThreadPool.hpp"
+#include <vector>
+
+// Multi-core whole-buffer line encoding / decoding. The only state crossing bit
+// boundaries is the parity of the ones seen so far (NRZ-I level, Diff Manchester
+// level, AMI polarity) and, for the NRZ-I decoder, the average of the previous
+// window. Each chunk's starting state is found with a popcount prefix scan, then
+// chunks are processed independently into one preallocated output. Results are
+// bit-exact with DigitalSignalGenerator::encode / decode.
+namespace parallel {
+
+SampledSignal encode(LineCode code, const BitStream& data, double bit_duration, int sampling_rate,
+                     ThreadPool& pool = ThreadPool::shared());
+SampledSignalF encode_f32(LineCode code, const BitStream& data, double bit_duration, int sampling_rate,
+                          ThreadPool& pool = ThreadPool::shared());
+SampledSignalI8 encode_i8(LineCode code, const BitStream& data, double bit_duration, int sampling_rate,
+                          ThreadPool& pool = ThreadPool::shared());
+
+BitStream decode(LineCode code, const std::vector<double>& signal, int sampling_rate,
+                 ThreadPool& pool = ThreadPool::shared());
+BitStream decode(LineCode code, const std::vector<float>& signal, int sampling_rate,
+                 ThreadPool& pool = ThreadPool::shared());
+BitStream decode(LineCode code, const std::vector<std::int8_t>& signal, int sampling_rate,
+                 ThreadPool& pool = ThreadPool::shared());
+
+} // namespace parallel
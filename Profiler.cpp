@@ -0,0 +1,152 @@
+#include "Profiler.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <stdexcept>
+
+namespace profiler {
+
+namespace {
+
+// about 14 MiB of events; totals keep counting past it
+constexpr size_t max_events = size_t(1) << 18;
+
+struct Totals {
+    const char* name;
+    StageStats stats;
+};
+
+struct State {
+    std::mutex mutex;
+    std::vector<Event> events;
+    std::vector<Totals> totals;      // few stages: linear search by literal address
+    std::uint64_t dropped = 0;
+};
+
+State& state() {
+    static State s;
+    return s;
+}
+
+std::atomic<bool> g_enabled{true};
+std::atomic<std::uint32_t> g_next_thread{0};
+
+const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+
+void append_escaped(std::string& out, const char* s) {
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out += '\\';
+        out += *s;
+    }
+}
+
+} // namespace
+
+bool enabled() { return compiled_in && g_enabled.load(std::memory_order_relaxed); }
+void set_enabled(bool on) { g_enabled.store(on, std::memory_order_relaxed); }
+
+std::uint64_t now_ns() {
+    return (std::uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+}
+
+std::uint32_t thread_index() {
+    thread_local std::uint32_t index = g_next_thread.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void record(const Event& event) {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    if (s.events.size() < max_events) s.events.push_back(event);
+    else ++s.dropped;
+    auto it = std::find_if(s.totals.begin(), s.totals.end(), [&](const Totals& t) { return t.name == event.name; });
+    if (it == s.totals.end()) {
+        s.totals.push_back({event.name, StageStats{}});
+        it = s.totals.end() - 1;
+        it->stats.name = event.name;
+    }
+    StageStats& st = it->stats;
+    ++st.calls;
+    st.total_ns += event.duration_ns;
+    st.max_ns = std::max(st.max_ns, event.duration_ns);
+    st.counters.bits += event.counters.bits;
+    st.counters.samples += event.counters.samples;
+    st.counters.bytes += event.counters.bytes;
+}
+
+std::vector<StageStats> summary() {
+    std::vector<StageStats> out;
+    {
+        State& s = state();
+        std::lock_guard<std::mutex> lock(s.mutex);
+        // the same stage name may be separate literals in different translation units
+        for (const Totals& t : s.totals) {
+            auto it = std::find_if(out.begin(), out.end(), [&](const StageStats& o) { return o.name == t.stats.name; });
+            if (it == out.end()) { out.push_back(t.stats); continue; }
+            it->calls += t.stats.calls;
+            it->total_ns += t.stats.total_ns;
+            it->max_ns = std::max(it->max_ns, t.stats.max_ns);
+            it->counters.bits += t.stats.counters.bits;
+            it->counters.samples += t.stats.counters.samples;
+            it->counters.bytes += t.stats.counters.bytes;
+        }
+    }
+    std::sort(out.begin(), out.end(), [](const StageStats& a, const StageStats& b) { return a.total_ns > b.total_ns; });
+    return out;
+}
+
+std::vector<Event> events() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.events;
+}
+
+std::uint64_t dropped() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    return s.dropped;
+}
+
+void reset() {
+    State& s = state();
+    std::lock_guard<std::mutex> lock(s.mutex);
+    s.events.clear();
+    s.totals.clear();
+    s.dropped = 0;
+}
+
+// Trace Event Format: complete ("X") events, timestamps in microseconds
+std::string chrome_trace_json() {
+    std::vector<Event> evs = events();
+    std::sort(evs.begin(), evs.end(), [](const Event& a, const Event& b) { return a.start_ns < b.start_ns; });
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+    char buf[256];
+    for (size_t i = 0; i < evs.size(); ++i) {
+        const Event& e = evs[i];
+        if (i) out += ',';
+        out += "\n{\"name\":\"";
+        append_escaped(out, e.name);
+        std::snprintf(buf, sizeof(buf),
+                      "\",\"cat\":\"dsg\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,"
+                      "\"args\":{\"bits\":%llu,\"samples\":%llu,\"bytes\":%llu}}",
+                      (unsigned)e.thread, e.start_ns / 1000.0, e.duration_ns / 1000.0,
+                      (unsigned long long)e.counters.bits, (unsigned long long)e.counters.samples,
+                      (unsigned long long)e.counters.bytes);
+        out += buf;
+    }
+    out += "\n]}\n";
+    return out;
+}
+
+void write_chrome_trace(const std::string& path) {
+    std::string json = chrome_trace_json();
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) throw std::runtime_error("cannot open " + path);
+    bool ok = std::fwrite(json.data(), 1, json.size(), f) == json.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) throw std::runtime_error("cannot write " + path);
+}
+
+} // namespace profiler
@@ -0,0 +1,177 @@
+#include "RunLengthSignal.hpp"
+#include "LineCodeKernels.hpp"
+#include "StreamingCodec.hpp"
+#include <stdexcept>
+
+double RunLengthSignal::mean() const {
+    if (count == 0) return 0.0;
+    double acc = 0.0;
+    for (size_t r = 0; r < levels.size(); ++r) acc += levels[r] * (double)run_length(r);
+    return acc / (double)count;
+}
+
+double RunLengthSignal::stddev() const {
+    if (count == 0) return 0.0;
+    double m = mean(), var = 0.0;
+    for (size_t r = 0; r < levels.size(); ++r) var += (levels[r] - m) * (levels[r] - m) * (double)run_length(r);
+    return std::sqrt(var / (double)count);
+}
+
+namespace {
+
+template <LineCode C>
+void encode_runs_kernel(const BitStream& data, size_t first, size_t last, std::uint64_t spb, double& state, RunLengthSignal& out) {
+    std::uint64_t half = spb / 2;
+    for (size_t i = first; i < last; ++i) {
+        double a, b;
+        kernels::Code<C>::levels(data[i], state, a, b);
+        if constexpr (kernels::Code<C>::split) {
+            out.push((std::int8_t)a, half);
+            out.push((std::int8_t)b, spb - half);
+        } else {
+            out.push((std::int8_t)a, spb);
+        }
+    }
+}
+
+// Positions i in [0, n) where f(bit i, bit i-1) holds, one word at a time; bit -1 is
+// taken as `before`.
+template <class F>
+size_t count_where(const BitStream& data, bool before, F f) {
+    using W = BitStream::word_type;
+    const W* w = data.words();
+    size_t words = data.word_count();
+    size_t n = 0;
+    for (size_t k = 0; k < words; ++k) {
+        W prev = (w[k] << 1) | (k ? w[k - 1] >> (BitStream::word_bits - 1) : W(before));
+        // trailing bits of the last word are zero in w but may be set by f
+        W valid = k + 1 < words || data.size() % BitStream::word_bits == 0
+            ? ~W(0) : (W(1) << (data.size() % BitStream::word_bits)) - 1;
+        n += (size_t)popcount64(f(w[k], prev) & valid);
+    }
+    return n;
+}
+
+} // namespace
+
+size_t count_runs(LineCode code, const BitStream& data) {
+    size_t n = data.size();
+    if (n == 0) return 0;
+    auto changes = [&] { return count_where(data, data[0], [](auto x, auto prev) { return x ^ prev; }); };
+    switch (code) {
+        case LineCode::NRZ_L: return 1 + changes();
+        // a new level at every later one
+        case LineCode::NRZ_I: return 1 + data.count(1, n);
+        // two halves per bit; equal bits meet with opposite levels, different bits merge
+        case LineCode::Manchester: return 2 * n - changes();
+        // the boundary before a one has no transition
+        case LineCode::DifferentialManchester: return 2 * n - data.count(1, n);
+        // every mark is a new level, and so is the first zero after a mark
+        case LineCode::AMI: return data.count() + count_where(data, true, [](auto x, auto prev) { return ~x & prev; });
+    }
+    return 0;
+}
+
+RunLengthSignal encode_runs(LineCode code, const BitStream& data, double bit_duration, int sampling_rate) {
+    RunLengthSignal out;
+    encode_runs(code, data, bit_duration, sampling_rate, out);
+    return out;
+}
+
+void encode_runs(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, RunLengthSignal& out) {
+    std::uint64_t spb = (std::uint64_t)samples_per_bit(code, sampling_rate);
+    if (spb == 0) throw std::invalid_argument("sampling_rate too small for line code");
+    out.clear();
+    out.t0 = 0.0;
+    out.dt = bit_duration / (double)spb;
+    size_t runs = count_runs(code, data);
+    out.starts.reserve(runs);
+    out.levels.reserve(runs);
+    double level = initial_level(code);
+    append_runs(code, data, 0, data.size(), spb, level, out);
+}
+
+void append_runs(LineCode code, const BitStream& data, size_t first, size_t last, std::uint64_t spb, double& level,
+                 RunLengthSignal& out) {
+    switch (code) {
+        case LineCode::NRZ_L:
+            // one run per stretch of equal bits, found word-wise
+            for (size_t pos = first; pos < last;) {
+                bool b = data[pos];
+                size_t end = std::min(last, data.find_next(pos, !b));
+                out.push((std::int8_t)(b ? 1 : -1), (end - pos) * spb);
+                pos = end;
+            }
+            break;
+        case LineCode::NRZ_I: encode_runs_kernel<LineCode::NRZ_I>(data, first, last, spb, level, out); break;
+        case LineCode::Manchester: encode_runs_kernel<LineCode::Manchester>(data, first, last, spb, level, out); break;
+        case LineCode::DifferentialManchester: encode_runs_kernel<LineCode::DifferentialManchester>(data, first, last, spb, level, out); break;
+        case LineCode::AMI: encode_runs_kernel<LineCode::AMI>(data, first, last, spb, level, out); break;
+    }
+}
+
+namespace {
+
+// Sums of consecutive sample ranges over the runs; ranges must be requested in
+// ascending order so the run cursor only moves forward.
+struct RunCursor {
+    const RunLengthSignal& s;
+    size_t r = 0;
+
+    std::uint64_t end_of(size_t k) const { return k + 1 < s.starts.size() ? s.starts[k + 1] : s.count; }
+
+    double sum(std::uint64_t a, std::uint64_t b) {
+        while (end_of(r) <= a) ++r;
+        double acc = 0.0;
+        size_t k = r;
+        for (std::uint64_t p = a; p < b; ++k) {
+            std::uint64_t e = std::min(b, end_of(k));
+            acc += s.levels[k] * (double)(e - p);
+            p = e;
+        }
+        return acc;
+    }
+};
+
+} // namespace
+
+void window_sums(const RunLengthSignal& signal, std::uint64_t first, std::uint64_t len, size_t count, double* out) {
+    if (count == 0) return;
+    RunCursor cur{signal, signal.find_run(first)};
+    for (size_t k = 0; k < count; ++k) out[k] = cur.sum(first + k * len, first + (k + 1) * len);
+}
+
+BitStream decode_runs(LineCode code, const RunLengthSignal& signal, int sampling_rate) {
+    BitStream out;
+    decode_runs(code, signal, sampling_rate, out);
+    return out;
+}
+
+void decode_runs(LineCode code, const RunLengthSignal& signal, int sampling_rate, BitStream& out) {
+    out.clear();
+    if (signal.empty()) return;
+    if (sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+    std::uint64_t s = (std::uint64_t)sampling_rate;
+    std::uint64_t half = s / 2;
+    std::uint64_t bits = signal.count / s;
+    out.reserve((size_t)bits);
+    bool split = splits_bit(code);
+    double last_level = reference_level(code, signal.levels[0]);
+
+    constexpr size_t block = 256;
+    double first[block], second[block];
+    RunCursor cur{signal};
+    for (std::uint64_t done = 0; done < bits; done += block) {
+        size_t n = (size_t)std::min<std::uint64_t>(block, bits - done);
+        for (size_t k = 0; k < n; ++k) {
+            std::uint64_t w = (done + k) * s;
+            if (split) {
+                first[k] = cur.sum(w, w + half);
+                second[k] = cur.sum(w + half, w + s);
+            } else {
+                first[k] = cur.sum(w, w + s);
+            }
+        }
+        decide_bits(code, sampling_rate, first, second, n, last_level, out);
+    }
+}
@@ -0,0 +1,113 @@
+#pragma once
+#include "BitStream.hpp"
+#include "LineCode.hpp"
+#include "SampledSignal.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// Piecewise-constant waveform stored as runs (level, length in samples) on the
+// implicit time axis t0 + i*dt. A line-coded signal costs one run per level change
+// instead of sampling_rate samples per bit; dense samples are produced lazily for
+// whatever window is asked for. Levels are the ternary line-code values, one byte each.
+struct RunLengthSignal {
+    double t0 = 0.0;
+    double dt = 1.0;
+    std::vector<std::uint64_t> starts; // first sample of each run, ascending
+    std::vector<std::int8_t> levels;  // -1, 0 or +1
+    std::uint64_t count = 0;           // total samples
+
+    size_t run_count() const { return levels.size(); }
+    bool empty() const { return count == 0; }
+    std::uint64_t run_length(size_t r) const { return (r + 1 < starts.size() ? starts[r + 1] : count) - starts[r]; }
+    double time(std::uint64_t i) const { return t0 + (double)i * dt; }
+    double duration() const { return (double)count * dt; }
+
+    void clear() { starts.clear(); levels.clear(); count = 0; }
+    // keeps the first `samples` samples (samples <= count)
+    void truncate(std::uint64_t samples) {
+        size_t runs = samples ? find_run(samples - 1) + 1 : 0;
+        starts.resize(runs);
+        levels.resize(runs);
+        count = samples;
+    }
+    size_t memory_bytes() const { return starts.capacity() * sizeof(std::uint64_t) + levels.capacity(); }
+
+    // appends `samples` samples at `level`, merging with the last run when equal
+    void push(std::int8_t level, std::uint64_t samples) {
+        if (samples == 0) return;
+        if (levels.empty() || levels.back() != level) {
+            starts.push_back(count);
+            levels.push_back(level);
+        }
+        count += samples;
+    }
+
+    // run containing sample i (i < count)
+    size_t find_run(std::uint64_t i) const {
+        return (size_t)(std::upper_bound(starts.begin(), starts.end(), i) - starts.begin()) - 1;
+    }
+
+    // sample index range [first, last) covering times [t_begin, t_end], clamped to the signal
+    std::pair<std::uint64_t, std::uint64_t> sample_range(double t_begin, double t_end) const {
+        double a = std::floor((t_begin - t0) / dt), b = std::ceil((t_end - t0) / dt) + 1;
+        std::uint64_t first = a <= 0 ? 0 : std::min<std::uint64_t>(count, (std::uint64_t)a);
+        std::uint64_t last = b <= 0 ? 0 : std::min<std::uint64_t>(count, (std::uint64_t)b);
+        return {first, std::max(first, last)};
+    }
+
+    // Lazily expands samples [first, first+n) into out; returns samples written.
+    template <class T>
+    size_t sample(std::uint64_t first, size_t n, T* out) const {
+        if (first >= count) return 0;
+        n = (size_t)std::min<std::uint64_t>(n, count - first);
+        size_t r = find_run(first);
+        std::uint64_t pos = first;
+        size_t written = 0;
+        while (written < n) {
+            std::uint64_t end = std::min<std::uint64_t>(first + n, r + 1 < starts.size() ? starts[r + 1] : count);
+            std::fill(out + written, out + written + (size_t)(end - pos), (T)levels[r]);
+            written += (size_t)(end - pos);
+            pos = end;
+            ++r;
+        }
+        return written;
+    }
+
+    template <class T>
+    BasicSampledSignal<T> expand() const {
+        BasicSampledSignal<T> s;
+        s.t0 = t0;
+        s.dt = dt;
+        s.samples.resize((size_t)count);
+        sample(0, (size_t)count, s.samples.data());
+        return s;
+    }
+
+    double mean() const;
+    double stddev() const;
+};
+
+// Run-length line encoding; expanding the result gives exactly the samples of
+// DigitalSignalGenerator::encode for the same code and sampling rate.
+RunLengthSignal encode_runs(LineCode code, const BitStream& data, double bit_duration, int sampling_rate);
+// Same into `out`, reserved exactly with count_runs and reusing its capacity.
+void encode_runs(LineCode code, const BitStream& data, double bit_duration, int sampling_rate, RunLengthSignal& out);
+// Number of runs encode_runs produces for data (word-wise popcounts, no encoding).
+size_t count_runs(LineCode code, const BitStream& data);
+// Appends the runs of bits [first, last) at spb samples per bit to out. level carries the
+// NRZ-I / Diff Manchester / AMI state between calls (initial_level(code) before bit 0),
+// so encoding a stream piecewise gives exactly the runs of encode_runs.
+void append_runs(LineCode code, const BitStream& data, size_t first, size_t last, std::uint64_t spb, double& level,
+                 RunLengthSignal& out);
+
+// Sums of `count` consecutive windows of `len` samples starting at sample `first`
+// (level * overlap per run, no dense samples).
+void window_sums(const RunLengthSignal& signal, std::uint64_t first, std::uint64_t len, size_t count, double* out);
+
+// Decoding directly on runs (window sums are level * overlap), bit-exact with the
+// dense decoders on line-coded signals.
+BitStream decode_runs(LineCode code, const RunLengthSignal& signal, int sampling_rate);
+void decode_runs(LineCode code, const RunLengthSignal& signal, int sampling_rate, BitStream& out);
@@ -0,0 +1,32 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Uniformly sampled waveform. The time axis is implicit: sample i is at t0 + i*dt,
+// so only the sample values are stored. T is the sample format: double, float, or
+// int8 for the ternary line-code levels -1 / 0 / +1 (an eighth of the double size).
+template <class T>
+struct BasicSampledSignal {
+    using value_type = T;
+
+    double t0 = 0.0;
+    double dt = 1.0;
+    std::vector<T> samples;
+
+    size_t count() const { return samples.size(); }
+    bool empty() const { return samples.empty(); }
+    double time(size_t i) const { return t0 + (double)i * dt; }
+    double duration() const { return (double)samples.size() * dt; }
+
+    // materialized time axis, for callers that still want (time, signal) pairs
+    std::vector<double> time_axis() const {
+        std::vector<double> t(samples.size());
+        for (size_t i = 0; i < t.size(); ++i) t[i] = time(i);
+        return t;
+    }
+};
+
+using SampledSignal = BasicSampledSignal<double>;
+using SampledSignalF = BasicSampledSignal<float>;
+using SampledSignalI8 = BasicSampledSignal<std::int8_t>;
@@ -0,0 +1,142 @@
+#include "Scrambler.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+AmiScrambler::AmiScrambler(Scrambler scrambler)
+    : scrambler_(scrambler), group_(scrambler == Scrambler::B8ZS ? 8 : scrambler == Scrambler::HDB3 ? 4 : 0) { }
+
+// writes the complete substitution groups of the pending zero run
+size_t AmiScrambler::emit_groups(std::int8_t* s) {
+    if (group_ == 0) {
+        std::memset(s, 0, zeros_);
+        size_t n = zeros_;
+        zeros_ = 0;
+        return n;
+    }
+    size_t n = zeros_ / group_ * group_;
+    std::memset(s, 0, n);
+    for (size_t j = 0; j < n; j += group_, s += group_) {
+        if (scrambler_ == Scrambler::B8ZS) {
+            // 000VB0VB: the polarity of the last pulse is unchanged afterwards
+            s[3] = last_; s[4] = (std::int8_t)-last_;
+            s[6] = (std::int8_t)-last_; s[7] = last_;
+        } else {
+            if (pulses_ % 2 == 0) {
+                last_ = (std::int8_t)-last_;
+                s[0] = last_;          // B
+            }
+            s[3] = last_;              // V
+            pulses_ = 0;
+        }
+    }
+    zeros_ -= n;
+    return n;
+}
+
+size_t AmiScrambler::push(const BitStream& bits, size_t first, size_t count, std::int8_t* out) {
+    size_t end = first + count;
+    size_t w = 0;
+    size_t pos = first;
+    while (pos < end) {
+        size_t one = std::min(bits.find_next(pos, true), end);
+        zeros_ += one - pos;
+        w += emit_groups(out + w);
+        if (one == end) break;
+        // the run ended before a mark: the rest of it stays plain zeros
+        std::memset(out + w, 0, zeros_);
+        w += zeros_;
+        zeros_ = 0;
+        last_ = (std::int8_t)-last_;
+        out[w++] = last_;
+        ++pulses_;
+        pos = one + 1;
+    }
+    return w;
+}
+
+size_t AmiScrambler::finish(std::int8_t* out) {
+    size_t n = zeros_;
+    std::memset(out, 0, n);
+    zeros_ = 0;
+    return n;
+}
+
+// Examines buf_ from scanned_ on. A B8ZS violation needs the 4 symbols after it to be
+// classified; unless final, scanning stops in front of one that lacks them.
+void AmiDescrambler::scan(bool final) {
+    size_t n = buf_.size();
+    std::int8_t* s = buf_.data();
+    size_t i = scanned_;
+    for (; i < n; ++i) {
+        std::int8_t v = s[i];
+        if (v == 0) continue;
+        if (v != last_ || scrambler_ == Scrambler::None) { last_ = v; continue; }
+        // violation
+        if (scrambler_ == Scrambler::B8ZS) {
+            if (i + 4 >= n && !final) break;
+            if (i >= 3 && i + 4 < n) {
+                last_ = s[i + 4];
+                std::memset(s + i - 3, 0, 8);
+                i += 4;
+            } else {
+                last_ = v;
+            }
+        } else {
+            if (i >= 3 && s[i - 3] == v) s[i - 3] = 0;   // B00V
+            s[i] = 0;
+            last_ = v;
+        }
+    }
+    scanned_ = i;
+}
+
+void AmiDescrambler::emit(size_t n, BitStream& out) {
+    const std::int8_t* s = buf_.data();
+    size_t k = 0;
+    // whole words once the output is word-aligned
+    for (; k < n && out.size() % BitStream::word_bits; ++k) out.push_back(s[k] != 0);
+    for (; k + BitStream::word_bits <= n; k += BitStream::word_bits) {
+        BitStream::word_type acc = 0;
+        for (size_t b = 0; b < BitStream::word_bits; ++b) acc |= BitStream::word_type(s[k + b] != 0) << b;
+        out.append(acc, BitStream::word_bits);
+    }
+    for (; k < n; ++k) out.push_back(s[k] != 0);
+    buf_.erase(buf_.begin(), buf_.begin() + (std::ptrdiff_t)n);
+    scanned_ -= n;
+}
+
+void AmiDescrambler::push(const std::int8_t* symbols, size_t n, BitStream& out) {
+    buf_.insert(buf_.end(), symbols, symbols + n);
+    scan(false);
+    // a later violation can clear at most the 3 symbols in front of it
+    if (scanned_ > 3) emit(scanned_ - 3, out);
+}
+
+void AmiDescrambler::finish(BitStream& out) {
+    scan(true);
+    emit(buf_.size(), out);
+}
+
+void scramble_ami(const BitStream& bits, Scrambler scrambler, std::int8_t* symbols) {
+    AmiScrambler enc(scrambler);
+    size_t w = enc.push(bits, 0, bits.size(), symbols);
+    enc.finish(symbols + w);
+}
+
+BitStream descramble_ami(const std::int8_t* symbols, size_t n, Scrambler scrambler) {
+    BitStream out;
+    out.reserve(n);
+    AmiDescrambler dec(scrambler);
+    dec.push(symbols, n, out);
+    dec.finish(out);
+    return out;
+}
+
+void ami_symbols(const double* window_sums, size_t n, int sampling_rate, std::int8_t* symbols) {
+    double s = (double)sampling_rate;
+    for (size_t k = 0; k < n; ++k) {
+        double avg = window_sums[k] / s;
+        symbols[k] = std::abs(avg) > 0.1 ? (avg > 0 ? 1 : -1) : 0;
+    }
+}
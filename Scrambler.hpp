@@ -0,0 +1,74 @@
+#pragma once
+#include "BitStream.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Zero-substitution scramblers for AMI lines.
+//   B8ZS (T1): every 8 zeros -> 000VB0VB
+//   HDB3 (E1): every 4 zeros -> 000V when an odd number of pulses was sent since the
+//              last violation, B00V when even (so violations alternate in polarity)
+// B is a normal alternating mark, V a bipolar violation (same polarity as the pulse
+// before it). Substitutions start at the beginning of each zero run, as in
+// DigitalSignalGenerator::b8zs_scramble / hdb3_scramble.
+enum class Scrambler { None, B8ZS, HDB3 };
+
+inline const char* scrambler_name(Scrambler s) {
+    switch (s) {
+        case Scrambler::None: return "None";
+        case Scrambler::B8ZS: return "B8ZS";
+        case Scrambler::HDB3: return "HDB3";
+    }
+    return "";
+}
+
+// Chunked scrambling AMI encoder. Carries the last pulse polarity, the pulse parity
+// and a zero run that may continue into the next chunk; the symbols of such a run
+// are written once its substitution groups are complete, so a call can write up to
+// group-1 symbols fewer (or more) than it consumed.
+class AmiScrambler {
+public:
+    explicit AmiScrambler(Scrambler scrambler);
+
+    // Consumes bits [first, first+count) and writes line symbols (-1, 0, +1) to out,
+    // which needs room for count + 7; returns the number written.
+    size_t push(const BitStream& bits, size_t first, size_t count, std::int8_t* out);
+    // Writes the held-back zeros; returns the number written.
+    size_t finish(std::int8_t* out);
+
+private:
+    size_t emit_groups(std::int8_t* out);
+
+    Scrambler scrambler_;
+    size_t group_;
+    std::int8_t last_ = -1;    // polarity of the previous pulse (AMI initial level)
+    size_t pulses_ = 0;        // pulses since the last violation (HDB3)
+    size_t zeros_ = 0;         // pending zero run
+};
+
+// Chunked inverse: symbols -> bits with every recognised substitution removed. The
+// last few symbols of a chunk are held until a violation there can be classified.
+class AmiDescrambler {
+public:
+    explicit AmiDescrambler(Scrambler scrambler) : scrambler_(scrambler) { }
+
+    void push(const std::int8_t* symbols, size_t n, BitStream& out);
+    void finish(BitStream& out);
+
+private:
+    void scan(bool final);
+    void emit(size_t n, BitStream& out);
+
+    Scrambler scrambler_;
+    std::int8_t last_ = -1;
+    std::vector<std::int8_t> buf_;
+    size_t scanned_ = 0;       // symbols of buf_ already examined
+};
+
+// Whole-stream forms. Single pass; zero runs are located word-wise. The first mark
+// is +1 (AMI initial level -1).
+void scramble_ami(const BitStream& bits, Scrambler scrambler, std::int8_t* symbols);
+BitStream descramble_ami(const std::int8_t* symbols, size_t n, Scrambler scrambler);
+
+// symbol decisions from AMI window sums (same 0.1 threshold as the AMI decoder)
+void ami_symbols(const double* window_sums, size_t n, int sampling_rate, std::int8_t* symbols);
@@ -0,0 +1,506 @@
+#include "SimdKernels.hpp"
+#include <atomic>
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define DSG_X86_DISPATCH 1
+#include <immintrin.h>
+#endif
+
+namespace simd {
+
+namespace {
+
+double sum_scalar(const double* x, size_t n) {
+    double acc = 0.0;
+    for (size_t i = 0; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+double sum_scalar(const float* x, size_t n) {
+    float acc = 0.0f;
+    for (size_t i = 0; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+void min_max_scalar(const double* x, size_t n, double& mn, double& mx) {
+    double lo = x[0], hi = x[0];
+    for (size_t i = 1; i < n; ++i) {
+        if (x[i] < lo) lo = x[i];
+        if (hi < x[i]) hi = x[i];
+    }
+    mn = lo;
+    mx = hi;
+}
+
+inline void butterfly(double* re0, double* im0, double* re1, double* im1, const double* wr, const double* wi, size_t j) {
+    double tr = re1[j] * wr[j] - im1[j] * wi[j];
+    double ti = re1[j] * wi[j] + im1[j] * wr[j];
+    re1[j] = re0[j] - tr;
+    im1[j] = im0[j] - ti;
+    re0[j] += tr;
+    im0[j] += ti;
+}
+
+void butterflies_scalar(double* re0, double* im0, double* re1, double* im1, const double* wr, const double* wi, size_t n) {
+    for (size_t j = 0; j < n; ++j) butterfly(re0, im0, re1, im1, wr, wi, j);
+}
+
+void quantize_scalar(const double* x, size_t n, double mn, double range, double top, std::int32_t* out) {
+    for (size_t i = 0; i < n; ++i) out[i] = (std::int32_t)(((x[i] - mn) / range) * top);
+}
+
+#if DSG_X86_DISPATCH
+__attribute__((target("sse2"))) double sum_sse2(const double* x, size_t n) {
+    __m128d a0 = _mm_setzero_pd(), a1 = _mm_setzero_pd();
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        a0 = _mm_add_pd(a0, _mm_loadu_pd(x + i));
+        a1 = _mm_add_pd(a1, _mm_loadu_pd(x + i + 2));
+    }
+    a0 = _mm_add_pd(a0, a1);
+    double lanes[2];
+    _mm_storeu_pd(lanes, a0);
+    double acc = lanes[0] + lanes[1];
+    for (; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+__attribute__((target("sse2"))) double sum_sse2(const float* x, size_t n) {
+    __m128 a0 = _mm_setzero_ps(), a1 = _mm_setzero_ps();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm_add_ps(a0, _mm_loadu_ps(x + i));
+        a1 = _mm_add_ps(a1, _mm_loadu_ps(x + i + 4));
+    }
+    a0 = _mm_add_ps(a0, a1);
+    float lanes[4];
+    _mm_storeu_ps(lanes, a0);
+    float acc = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+__attribute__((target("avx2"))) double sum_avx2(const double* x, size_t n) {
+    __m256d a0 = _mm256_setzero_pd(), a1 = _mm256_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i));
+        a1 = _mm256_add_pd(a1, _mm256_loadu_pd(x + i + 4));
+    }
+    if (i + 4 <= n) { a0 = _mm256_add_pd(a0, _mm256_loadu_pd(x + i)); i += 4; }
+    a0 = _mm256_add_pd(a0, a1);
+    __m128d h = _mm_add_pd(_mm256_castpd256_pd128(a0), _mm256_extractf128_pd(a0, 1));
+    double acc = _mm_cvtsd_f64(_mm_add_sd(h, _mm_unpackhi_pd(h, h)));
+    for (; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+__attribute__((target("avx2"))) double sum_avx2(const float* x, size_t n) {
+    __m256 a0 = _mm256_setzero_ps(), a1 = _mm256_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i));
+        a1 = _mm256_add_ps(a1, _mm256_loadu_ps(x + i + 8));
+    }
+    if (i + 8 <= n) { a0 = _mm256_add_ps(a0, _mm256_loadu_ps(x + i)); i += 8; }
+    a0 = _mm256_add_ps(a0, a1);
+    __m128 h = _mm_add_ps(_mm256_castps256_ps128(a0), _mm256_extractf128_ps(a0, 1));
+    h = _mm_add_ps(h, _mm_movehl_ps(h, h));
+    float acc = _mm_cvtss_f32(_mm_add_ss(h, _mm_shuffle_ps(h, h, 1)));
+    for (; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+__attribute__((target("avx512f"))) double sum_avx512(const double* x, size_t n) {
+    __m512d a0 = _mm512_setzero_pd();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) a0 = _mm512_add_pd(a0, _mm512_loadu_pd(x + i));
+    if (i < n) {
+        __mmask8 m = (__mmask8)((1u << (n - i)) - 1);
+        a0 = _mm512_add_pd(a0, _mm512_maskz_loadu_pd(m, x + i));
+    }
+    double lanes[8];
+    _mm512_storeu_pd(lanes, a0);
+    return ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+}
+
+__attribute__((target("avx512f"))) double sum_avx512(const float* x, size_t n) {
+    __m512 a0 = _mm512_setzero_ps();
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) a0 = _mm512_add_ps(a0, _mm512_loadu_ps(x + i));
+    if (i < n) {
+        __mmask16 m = (__mmask16)((1u << (n - i)) - 1);
+        a0 = _mm512_add_ps(a0, _mm512_maskz_loadu_ps(m, x + i));
+    }
+    float lanes[16];
+    _mm512_storeu_ps(lanes, a0);
+    float acc = 0.0f;
+    for (float v : lanes) acc += v;
+    return acc;
+}
+
+__attribute__((target("avx2"))) void min_max_avx2(const double* x, size_t n, double& mn, double& mx) {
+    if (n < 8) { min_max_scalar(x, n, mn, mx); return; }
+    __m256d lo0 = _mm256_loadu_pd(x), hi0 = lo0, lo1 = _mm256_loadu_pd(x + 4), hi1 = lo1;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m256d a = _mm256_loadu_pd(x + i), b = _mm256_loadu_pd(x + i + 4);
+        lo0 = _mm256_min_pd(lo0, a); hi0 = _mm256_max_pd(hi0, a);
+        lo1 = _mm256_min_pd(lo1, b); hi1 = _mm256_max_pd(hi1, b);
+    }
+    double lo[8], hi[8];
+    _mm256_storeu_pd(lo, _mm256_min_pd(lo0, lo1));
+    _mm256_storeu_pd(hi, _mm256_max_pd(hi0, hi1));
+    double l = lo[0], h = hi[0];
+    for (int k = 1; k < 4; ++k) { if (lo[k] < l) l = lo[k]; if (h < hi[k]) h = hi[k]; }
+    for (; i < n; ++i) { if (x[i] < l) l = x[i]; if (h < x[i]) h = x[i]; }
+    mn = l;
+    mx = h;
+}
+
+__attribute__((target("avx512f"))) void min_max_avx512(const double* x, size_t n, double& mn, double& mx) {
+    if (n < 8) { min_max_scalar(x, n, mn, mx); return; }
+    __m512d lo0 = _mm512_loadu_pd(x), hi0 = lo0;
+    size_t i = 8;
+    for (; i + 8 <= n; i += 8) {
+        __m512d a = _mm512_loadu_pd(x + i);
+        // masked forms with an explicit source: the plain ones trip GCC's -Wmaybe-uninitialized
+        lo0 = _mm512_mask_min_pd(lo0, 0xFF, lo0, a);
+        hi0 = _mm512_mask_max_pd(hi0, 0xFF, hi0, a);
+    }
+    double lo[8], hi[8];
+    _mm512_storeu_pd(lo, lo0);
+    _mm512_storeu_pd(hi, hi0);
+    double l = lo[0], h = hi[0];
+    for (int k = 1; k < 8; ++k) { if (lo[k] < l) l = lo[k]; if (h < hi[k]) h = hi[k]; }
+    for (; i < n; ++i) { if (x[i] < l) l = x[i]; if (h < x[i]) h = x[i]; }
+    mn = l;
+    mx = h;
+}
+
+__attribute__((target("avx2"))) void quantize_avx2(const double* x, size_t n, double mn, double range, double top, std::int32_t* out) {
+    __m256d vmn = _mm256_set1_pd(mn), vrange = _mm256_set1_pd(range), vtop = _mm256_set1_pd(top);
+    size_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+        __m256d v = _mm256_div_pd(_mm256_sub_pd(_mm256_loadu_pd(x + i), vmn), vrange);
+        _mm_storeu_si128((__m128i*)(out + i), _mm256_cvttpd_epi32(_mm256_mul_pd(v, vtop)));
+    }
+    for (; i < n; ++i) out[i] = (std::int32_t)(((x[i] - mn) / range) * top);
+}
+
+__attribute__((target("avx512f"))) void quantize_avx512(const double* x, size_t n, double mn, double range, double top, std::int32_t* out) {
+    __m512d vmn = _mm512_set1_pd(mn), vrange = _mm512_set1_pd(range), vtop = _mm512_set1_pd(top);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m512d v = _mm512_div_pd(_mm512_sub_pd(_mm512_loadu_pd(x + i), vmn), vrange);
+        _mm256_storeu_si256((__m256i*)(out + i), _mm512_mask_cvttpd_epi32(_mm256_setzero_si256(), 0xFF, _mm512_mul_pd(v, vtop)));
+    }
+    for (; i < n; ++i) out[i] = (std::int32_t)(((x[i] - mn) / range) * top);
+}
+
+// no FMA: every level rounds like the scalar butterfly
+__attribute__((target("sse2"))) void butterflies_sse2(double* re0, double* im0, double* re1, double* im1, const double* wr,
+                                                      const double* wi, size_t n) {
+    size_t j = 0;
+    for (; j + 2 <= n; j += 2) {
+        __m128d ar = _mm_loadu_pd(re0 + j), ai = _mm_loadu_pd(im0 + j);
+        __m128d br = _mm_loadu_pd(re1 + j), bi = _mm_loadu_pd(im1 + j);
+        __m128d cr = _mm_loadu_pd(wr + j), ci = _mm_loadu_pd(wi + j);
+        __m128d tr = _mm_sub_pd(_mm_mul_pd(br, cr), _mm_mul_pd(bi, ci));
+        __m128d ti = _mm_add_pd(_mm_mul_pd(br, ci), _mm_mul_pd(bi, cr));
+        _mm_storeu_pd(re1 + j, _mm_sub_pd(ar, tr));
+        _mm_storeu_pd(im1 + j, _mm_sub_pd(ai, ti));
+        _mm_storeu_pd(re0 + j, _mm_add_pd(ar, tr));
+        _mm_storeu_pd(im0 + j, _mm_add_pd(ai, ti));
+    }
+    for (; j < n; ++j) butterfly(re0, im0, re1, im1, wr, wi, j);
+}
+
+__attribute__((target("avx2"))) void butterflies_avx2(double* re0, double* im0, double* re1, double* im1, const double* wr,
+                                                      const double* wi, size_t n) {
+    size_t j = 0;
+    for (; j + 4 <= n; j += 4) {
+        __m256d ar = _mm256_loadu_pd(re0 + j), ai = _mm256_loadu_pd(im0 + j);
+        __m256d br = _mm256_loadu_pd(re1 + j), bi = _mm256_loadu_pd(im1 + j);
+        __m256d cr = _mm256_loadu_pd(wr + j), ci = _mm256_loadu_pd(wi + j);
+        __m256d tr = _mm256_sub_pd(_mm256_mul_pd(br, cr), _mm256_mul_pd(bi, ci));
+        __m256d ti = _mm256_add_pd(_mm256_mul_pd(br, ci), _mm256_mul_pd(bi, cr));
+        _mm256_storeu_pd(re1 + j, _mm256_sub_pd(ar, tr));
+        _mm256_storeu_pd(im1 + j, _mm256_sub_pd(ai, ti));
+        _mm256_storeu_pd(re0 + j, _mm256_add_pd(ar, tr));
+        _mm256_storeu_pd(im0 + j, _mm256_add_pd(ai, ti));
+    }
+    for (; j < n; ++j) butterfly(re0, im0, re1, im1, wr, wi, j);
+}
+
+__attribute__((target("avx512f"))) void butterflies_avx512(double* re0, double* im0, double* re1, double* im1, const double* wr,
+                                                           const double* wi, size_t n) {
+    size_t j = 0;
+    for (; j + 8 <= n; j += 8) {
+        __m512d ar = _mm512_loadu_pd(re0 + j), ai = _mm512_loadu_pd(im0 + j);
+        __m512d br = _mm512_loadu_pd(re1 + j), bi = _mm512_loadu_pd(im1 + j);
+        __m512d cr = _mm512_loadu_pd(wr + j), ci = _mm512_loadu_pd(wi + j);
+        __m512d tr = _mm512_sub_pd(_mm512_mul_pd(br, cr), _mm512_mul_pd(bi, ci));
+        __m512d ti = _mm512_add_pd(_mm512_mul_pd(br, ci), _mm512_mul_pd(bi, cr));
+        _mm512_storeu_pd(re1 + j, _mm512_sub_pd(ar, tr));
+        _mm512_storeu_pd(im1 + j, _mm512_sub_pd(ai, ti));
+        _mm512_storeu_pd(re0 + j, _mm512_add_pd(ar, tr));
+        _mm512_storeu_pd(im0 + j, _mm512_add_pd(ai, ti));
+    }
+    if (j < n) butterflies_avx2(re0 + j, im0 + j, re1 + j, im1 + j, wr + j, wi + j, n - j);
+}
+#endif
+
+Level detect() {
+#if DSG_X86_DISPATCH
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return Level::AVX512;
+    if (__builtin_cpu_supports("avx2")) return Level::AVX2;
+    if (__builtin_cpu_supports("sse2")) return Level::SSE2;
+#endif
+    return Level::Scalar;
+}
+
+std::atomic<int> g_level{-1};
+
+Level level_now() {
+    int l = g_level.load(std::memory_order_relaxed);
+    if (l < 0) {
+        l = (int)detected_level();
+        g_level.store(l, std::memory_order_relaxed);
+    }
+    return (Level)l;
+}
+
+template <class T>
+double sum_dispatch(const T* x, size_t n) {
+    switch (level_now()) {
+#if DSG_X86_DISPATCH
+        case Level::AVX512: return sum_avx512(x, n);
+        case Level::AVX2: return sum_avx2(x, n);
+        case Level::SSE2: return sum_sse2(x, n);
+#endif
+        default: return sum_scalar(x, n);
+    }
+}
+
+// one segment loop per level so the reduction inlines into it
+template <class T>
+void segments_scalar(const T* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    const T* p = x + offset;
+    for (size_t k = 0; k < count; ++k, p += stride) out[k] = sum_scalar(p, len);
+}
+
+#if DSG_X86_DISPATCH
+template <class T>
+__attribute__((target("sse2"))) void segments_sse2(const T* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    const T* p = x + offset;
+    for (size_t k = 0; k < count; ++k, p += stride) out[k] = sum_sse2(p, len);
+}
+
+template <class T>
+__attribute__((target("avx2"))) void segments_avx2(const T* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    const T* p = x + offset;
+    for (size_t k = 0; k < count; ++k, p += stride) out[k] = sum_avx2(p, len);
+}
+
+template <class T>
+__attribute__((target("avx512f"))) void segments_avx512(const T* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    const T* p = x + offset;
+    for (size_t k = 0; k < count; ++k, p += stride) out[k] = sum_avx512(p, len);
+}
+#endif
+
+template <class T>
+void segment_dispatch(const T* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    switch (level_now()) {
+#if DSG_X86_DISPATCH
+        case Level::AVX512: segments_avx512(x, count, stride, offset, len, out); return;
+        case Level::AVX2: segments_avx2(x, count, stride, offset, len, out); return;
+        case Level::SSE2: segments_sse2(x, count, stride, offset, len, out); return;
+#endif
+        default: segments_scalar(x, count, stride, offset, len, out); return;
+    }
+}
+
+// int8 ternary samples: exact integer sums. The vector paths bias each byte by 128
+// and add with psadbw against zero (16 / 32 / 64 bytes per instruction).
+std::int64_t sum_i8_scalar(const std::int8_t* x, size_t n) {
+    std::int64_t acc = 0;
+    for (size_t i = 0; i < n; ++i) acc += x[i];
+    return acc;
+}
+
+void segments_i8_scalar(const std::int8_t* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    const std::int8_t* p = x + offset;
+    for (size_t k = 0; k < count; ++k, p += stride) out[k] = (double)sum_i8_scalar(p, len);
+}
+
+#if DSG_X86_DISPATCH
+// 16 x 0xFF then 16 x 0: the 16 bytes at lane_mask + 16 - n keep the first n lanes
+alignas(16) const unsigned char lane_mask[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF};
+
+__attribute__((target("sse2"))) inline std::int64_t hsum_epi64(__m128i v) {
+    std::uint64_t lanes[2];
+    _mm_storeu_si128((__m128i*)lanes, v);
+    return (std::int64_t)(lanes[0] + lanes[1]);
+}
+
+// Sum of p[0, len). Reads of whole 16-byte blocks may run past len (never past end):
+// the extra lanes are masked off.
+__attribute__((target("sse2"))) std::int64_t sum_i8_sse2(const std::int8_t* p, size_t len, const std::int8_t* end) {
+    const __m128i bias = _mm_set1_epi8((char)0x80), zero = _mm_setzero_si128();
+    __m128i acc = zero;
+    size_t i = 0;
+    for (; i + 16 <= len; i += 16)
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(_mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + i)), bias), zero));
+    size_t tail = len - i;
+    if (tail && p + i + 16 <= end) {
+        __m128i mask = _mm_loadu_si128((const __m128i*)(lane_mask + 16 - tail));
+        __m128i v = _mm_and_si128(_mm_xor_si128(_mm_loadu_si128((const __m128i*)(p + i)), bias), mask);
+        return hsum_epi64(_mm_add_epi64(acc, _mm_sad_epu8(v, zero))) - 128 * (std::int64_t)len;
+    }
+    std::int64_t s = hsum_epi64(acc) - 128 * (std::int64_t)i;
+    for (; i < len; ++i) s += p[i];
+    return s;
+}
+
+__attribute__((target("sse2"))) void segments_i8_sse2(const std::int8_t* x, size_t count, size_t stride, size_t offset,
+                                                      size_t len, double* out) {
+    const std::int8_t* p = x + offset;
+    const std::int8_t* end = p + (count - 1) * stride + len;
+    for (size_t k = 0; k < count; ++k, p += stride) out[k] = (double)sum_i8_sse2(p, len, end);
+}
+
+__attribute__((target("avx2"))) void segments_i8_avx2(const std::int8_t* x, size_t count, size_t stride, size_t offset,
+                                                      size_t len, double* out) {
+    const __m256i bias = _mm256_set1_epi8((char)0x80), zero = _mm256_setzero_si256();
+    const std::int8_t* p = x + offset;
+    const std::int8_t* end = p + (count - 1) * stride + len;
+    size_t wide = len / 32 * 32;
+    for (size_t k = 0; k < count; ++k, p += stride) {
+        __m256i acc = zero;
+        for (size_t i = 0; i < wide; i += 32)
+            acc = _mm256_add_epi64(acc, _mm256_sad_epu8(_mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(p + i)), bias), zero));
+        __m128i h = _mm_add_epi64(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+        out[k] = (double)(hsum_epi64(h) - 128 * (std::int64_t)wide + sum_i8_sse2(p + wide, len - wide, end));
+    }
+}
+
+// masked loads never touch bytes outside the segment
+__attribute__((target("avx512f,avx512bw"))) void segments_i8_avx512(const std::int8_t* x, size_t count, size_t stride,
+                                                                    size_t offset, size_t len, double* out) {
+    const __m512i bias = _mm512_set1_epi8((char)0x80), zero = _mm512_setzero_si512();
+    const std::int8_t* p = x + offset;
+    size_t wide = len / 64 * 64;
+    __mmask64 tail = len > wide ? (~0ULL >> (64 - (len - wide))) : 0;
+    for (size_t k = 0; k < count; ++k, p += stride) {
+        __m512i acc = zero;
+        for (size_t i = 0; i < wide; i += 64)
+            acc = _mm512_add_epi64(acc, _mm512_sad_epu8(_mm512_xor_si512(_mm512_loadu_si512(p + i), bias), zero));
+        if (tail) {
+            __m512i v = _mm512_maskz_mov_epi8(tail, _mm512_xor_si512(_mm512_maskz_loadu_epi8(tail, p + wide), bias));
+            acc = _mm512_add_epi64(acc, _mm512_sad_epu8(v, zero));
+        }
+        std::uint64_t lanes[8];
+        _mm512_storeu_si512(lanes, acc);
+        std::uint64_t total = ((lanes[0] + lanes[1]) + (lanes[2] + lanes[3])) + ((lanes[4] + lanes[5]) + (lanes[6] + lanes[7]));
+        out[k] = (double)((std::int64_t)total - 128 * (std::int64_t)len);
+    }
+}
+
+bool has_avx512bw() {
+    static const bool bw = __builtin_cpu_supports("avx512bw");
+    return bw;
+}
+#endif
+
+} // namespace
+
+Level detected_level() {
+    static const Level level = detect();
+    return level;
+}
+
+const char* level_name(Level level) {
+    switch (level) {
+        case Level::Scalar: return "scalar";
+        case Level::SSE2: return "SSE2";
+        case Level::AVX2: return "AVX2";
+        case Level::AVX512: return "AVX-512";
+    }
+    return "";
+}
+
+void set_level(Level level) {
+    if ((int)level > (int)detected_level()) level = detected_level();
+    g_level.store((int)level, std::memory_order_relaxed);
+}
+
+Level active_level() { return level_now(); }
+
+double sum(const double* x, size_t n) { return sum_dispatch(x, n); }
+double sum(const float* x, size_t n) { return sum_dispatch(x, n); }
+double sum(const std::int8_t* x, size_t n) {
+    double out = 0.0;
+    if (n) segment_sums(x, 1, n, 0, n, &out);
+    return out;
+}
+
+void segment_sums(const double* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    segment_dispatch(x, count, stride, offset, len, out);
+}
+
+void segment_sums(const float* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    segment_dispatch(x, count, stride, offset, len, out);
+}
+
+void segment_sums(const std::int8_t* x, size_t count, size_t stride, size_t offset, size_t len, double* out) {
+    if (count == 0) return;
+    switch (level_now()) {
+#if DSG_X86_DISPATCH
+        case Level::AVX512:
+            if (has_avx512bw()) { segments_i8_avx512(x, count, stride, offset, len, out); return; }
+            segments_i8_avx2(x, count, stride, offset, len, out);
+            return;
+        case Level::AVX2: segments_i8_avx2(x, count, stride, offset, len, out); return;
+        case Level::SSE2: segments_i8_sse2(x, count, stride, offset, len, out); return;
+#endif
+        default: segments_i8_scalar(x, count, stride, offset, len, out); return;
+    }
+}
+
+void min_max(const double* x, size_t n, double& mn, double& mx) {
+    switch (level_now()) {
+#if DSG_X86_DISPATCH
+        case Level::AVX512: min_max_avx512(x, n, mn, mx); return;
+        case Level::AVX2: min_max_avx2(x, n, mn, mx); return;
+#endif
+        default: min_max_scalar(x, n, mn, mx); return;
+    }
+}
+
+void quantize(const double* x, size_t n, double mn, double range, double top, std::int32_t* out) {
+    switch (level_now()) {
+#if DSG_X86_DISPATCH
+        case Level::AVX512: quantize_avx512(x, n, mn, range, top, out); return;
+        case Level::AVX2: quantize_avx2(x, n, mn, range, top, out); return;
+#endif
+        // SSE2 has no packed double->int32 beyond two lanes; the plain loop is as good
+        default: quantize_scalar(x, n, mn, range, top, out); return;
+    }
+}
+
+void butterflies(double* re0, double* im0, double* re1, double* im1, const double* wr, const double* wi, size_t n) {
+    switch (level_now()) {
+#if DSG_X86_DISPATCH
+        case Level::AVX512: butterflies_avx512(re0, im0, re1, im1, wr, wi, n); return;
+        case Level::AVX2: butterflies_avx2(re0, im0, re1, im1, wr, wi, n); return;
+        case Level::SSE2: butterflies_sse2(re0, im0, re1, im1, wr, wi, n); return;
+#endif
+        default: butterflies_scalar(re0, im0, re1, im1, wr, wi, n); return;
+    }
+}
+
+} // namespace simd
@@ -0,0 +1,39 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Vector reduction / conversion kernels with runtime dispatch. On x86 with GCC/Clang the best of
+// SSE2 / AVX2 / AVX-512 is picked once from CPUID; everywhere else the scalar path is used.
+namespace simd {
+
+enum class Level { Scalar, SSE2, AVX2, AVX512 };
+
+Level detected_level();
+const char* level_name(Level level);
+// Forces a lower level (benchmarks / debugging); requests above the detected level are clamped.
+void set_level(Level level);
+Level active_level();
+
+double sum(const double* x, size_t n);
+double sum(const float* x, size_t n);
+double sum(const std::int8_t* x, size_t n);
+
+// out[k] = sum of x[k*stride + offset .. k*stride + offset + len), for k < count
+void segment_sums(const double* x, size_t count, size_t stride, size_t offset, size_t len, double* out);
+void segment_sums(const float* x, size_t count, size_t stride, size_t offset, size_t len, double* out);
+// int8 ternary samples are summed exactly in integers (psadbw); AVX-512 level needs AVX-512BW
+void segment_sums(const std::int8_t* x, size_t count, size_t stride, size_t offset, size_t len, double* out);
+
+// single pass minimum and maximum of x[0..n), n > 0
+void min_max(const double* x, size_t n, double& mn, double& mx);
+
+// PCM quantizer: out[i] = (int32)(((x[i] - mn) / range) * top), truncating.
+// Equal to floor() because every x[i] >= mn.
+void quantize(const double* x, size_t n, double mn, double range, double top, std::int32_t* out);
+
+// Radix-2 FFT butterflies on split complex arrays, for j < n:
+//   t = x1[j] * w[j];  x1[j] = x0[j] - t;  x0[j] = x0[j] + t
+// with x = re + i*im and w = wr + i*wi. x0 and x1 must not overlap.
+void butterflies(double* re0, double* im0, double* re1, double* im1, const double* wr, const double* wi, size_t n);
+
+} // namespace simd
@@ -0,0 +1,63 @@
+#include "SourceCoding.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+PcmEncoder::PcmEncoder(double mn, double mx, int n_bits) : mn_(mn), range_(mx - mn), n_bits_(n_bits) {
+    if (n_bits < 1 || n_bits > 31) throw std::invalid_argument("n_bits must be in [1, 31]");
+    if (range_ == 0) range_ = 1e-10;
+    top_ = (double)((1u << n_bits) - 1);
+}
+
+PcmEncoder::PcmEncoder(double peak, Companding law)
+    : mn_(-peak), range_(2 * peak), top_(65535.0), n_bits_(8), companded_(true), law_(law) {
+    if (peak == 0) { mn_ = -1e-10; range_ = 2e-10; }
+}
+
+// code words are bit-reversed into the LSB-first word, 64 bits at a time
+inline void PcmEncoder::put(std::uint32_t value, BitStream& out) {
+    BitStream::word_type r = reverse_bits64(value) >> (64 - n_bits_);
+    acc_ |= r << used_;
+    if (used_ + n_bits_ >= 64) {
+        out.append(acc_, 64);
+        acc_ = used_ ? r >> (64 - used_) : 0;
+        used_ = used_ + n_bits_ - 64;
+    } else {
+        used_ += n_bits_;
+    }
+}
+
+void PcmEncoder::encode(const double* x, size_t n, BitStream& out) {
+    constexpr size_t block = 1024;
+    std::int32_t quant[block];
+    for (size_t i = 0; i < n; i += block) {
+        size_t m = std::min(block, n - i);
+        simd::quantize(x + i, m, mn_, range_, top_, quant);
+        if (companded_) {
+            for (size_t k = 0; k < m; ++k) put(compress_sample(law_, (std::int16_t)(quant[k] - 32768)), out);
+        } else {
+            for (size_t k = 0; k < m; ++k) put((std::uint32_t)quant[k], out);
+        }
+    }
+}
+
+void PcmEncoder::finish(BitStream& out) {
+    out.append(acc_, used_);
+    acc_ = 0;
+    used_ = 0;
+}
+
+void DeltaModulator::encode(const double* x, size_t n, BitStream& out) {
+    if (n == 0) return;
+    if (!started_) { approximation_ = x[0]; started_ = true; }
+    for (size_t i = 0; i < n; ++i) {
+        if (x[i] > approximation_) {
+            out.push_back(true);
+            approximation_ += step_;
+        } else {
+            out.push_back(false);
+            approximation_ -= step_;
+        }
+    }
+}
@@ -0,0 +1,47 @@
+#pragma once
+#include "BitStream.hpp"
+#include "Companding.hpp"
+#include <cstddef>
+#include <cstdint>
+
+// Chunked PCM quantizer; code words are appended MSB first. The input range is fixed
+// at construction (min / max, or the peak magnitude for companding), so a long
+// capture can be quantized piece by piece after a single min/max pass.
+class PcmEncoder {
+public:
+    // linear, n_bits in [1, 31]: (v - mn) / (mx - mn) * (2^n_bits - 1), truncated
+    PcmEncoder(double mn, double mx, int n_bits);
+    // 8-bit G.711: peak maps to 16-bit full scale, then through the compression table
+    PcmEncoder(double peak, Companding law);
+
+    int bits_per_sample() const { return n_bits_; }
+
+    void encode(const double* x, size_t n, BitStream& out);
+    // appends the bits still held in the packing word
+    void finish(BitStream& out);
+
+private:
+    void put(std::uint32_t value, BitStream& out);
+
+    double mn_, range_, top_;
+    int n_bits_;
+    bool companded_ = false;
+    Companding law_ = Companding::MuLaw;
+    BitStream::word_type acc_ = 0;
+    unsigned used_ = 0;
+};
+
+// Chunked delta modulator: 1 when the sample is above the running approximation
+// (which then steps up), 0 otherwise. The approximation starts at the first sample.
+class DeltaModulator {
+public:
+    explicit DeltaModulator(double step) : step_(step) { }
+
+    void encode(const double* x, size_t n, BitStream& out);
+    void reset() { started_ = false; }
+
+private:
+    double step_;
+    double approximation_ = 0.0;
+    bool started_ = false;
+};
@@ -0,0 +1,261 @@
+#include "Spectrum.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+
+constexpr double pi = 3.14159265358979323846;
+
+bool power_of_two(size_t n) { return n && (n & (n - 1)) == 0; }
+
+} // namespace
+
+std::shared_ptr<const FftPlan> FftPlan::get(size_t n) {
+    static std::mutex mutex;
+    static std::map<size_t, std::shared_ptr<const FftPlan>> plans;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& plan = plans[n];
+    if (!plan) plan = std::make_shared<const FftPlan>(n);
+    return plan;
+}
+
+FftPlan::FftPlan(size_t n) : n_(n) {
+    if (n < 4 || !power_of_two(n)) throw std::invalid_argument("FFT size must be a power of two >= 4");
+    size_t m = n / 2;
+    bitrev_.resize(m);
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < m) ++bits;
+    for (size_t i = 0; i < m; ++i) {
+        std::uint32_t r = 0;
+        for (unsigned b = 0; b < bits; ++b) r |= (std::uint32_t)((i >> b) & 1) << (bits - 1 - b);
+        bitrev_[i] = r;
+    }
+    wr_.resize(m > 1 ? m - 1 : 0);
+    wi_.resize(wr_.size());
+    for (size_t h = 1; h < m; h *= 2)
+        for (size_t j = 0; j < h; ++j) {
+            wr_[h - 1 + j] = std::cos(pi * (double)j / (double)h);
+            wi_[h - 1 + j] = -std::sin(pi * (double)j / (double)h);
+        }
+    sr_.resize(m);
+    si_.resize(m);
+    for (size_t k = 0; k < m; ++k) {
+        sr_[k] = std::cos(2.0 * pi * (double)k / (double)n);
+        si_[k] = std::sin(2.0 * pi * (double)k / (double)n);
+    }
+}
+
+void FftPlan::transform(double* re, double* im) const {
+    size_t m = n_ / 2;
+    if (m == 2) {
+        double tr = re[1], ti = im[1];
+        re[1] = re[0] - tr; im[1] = im[0] - ti;
+        re[0] += tr; im[0] += ti;
+        return;
+    }
+    // the first two stages have trivial twiddles (1, and 1 / -i): one radix-4 pass
+    for (size_t b = 0; b < m; b += 4) {
+        double r0 = re[b] + re[b + 1], i0 = im[b] + im[b + 1];
+        double r1 = re[b] - re[b + 1], i1 = im[b] - im[b + 1];
+        double r2 = re[b + 2] + re[b + 3], i2 = im[b + 2] + im[b + 3];
+        double r3 = im[b + 2] - im[b + 3], i3 = re[b + 3] - re[b + 2];   // (x2 - x3) * -i
+        re[b] = r0 + r2; im[b] = i0 + i2;
+        re[b + 2] = r0 - r2; im[b + 2] = i0 - i2;
+        re[b + 1] = r1 + r3; im[b + 1] = i1 + i3;
+        re[b + 3] = r1 - r3; im[b + 3] = i1 - i3;
+    }
+    for (size_t h = 4; h < m; h *= 2)
+        for (size_t b = 0; b < m; b += 2 * h)
+            simd::butterflies(re + b, im + b, re + b + h, im + b + h, wr_.data() + h - 1, wi_.data() + h - 1, h);
+}
+
+// z[k] = x[2k] + i x[2k+1] is transformed at n/2 points, then
+// X[k] = (Z[k] + conj Z[m-k]) / 2 + exp(-2 pi i k / n) (Z[k] - conj Z[m-k]) / 2i
+void FftPlan::power(const double* x, const double* window, double* re, double* im, double* out) const {
+    size_t m = n_ / 2;
+    for (size_t k = 0; k < m; ++k) {
+        std::uint32_t r = bitrev_[k];
+        re[r] = x[2 * k] * window[2 * k];
+        im[r] = x[2 * k + 1] * window[2 * k + 1];
+    }
+    transform(re, im);
+    out[0] = (re[0] + im[0]) * (re[0] + im[0]);
+    out[m] = (re[0] - im[0]) * (re[0] - im[0]);
+    for (size_t k = 1; k < m; ++k) {
+        double ar = re[k], ai = im[k], br = re[m - k], bi = -im[m - k];
+        double er = 0.5 * (ar + br), ei = 0.5 * (ai + bi);
+        double or_ = 0.5 * (ai - bi), oi = -0.5 * (ar - br);
+        double c = sr_[k], s = si_[k];
+        double xr = er + c * or_ + s * oi;
+        double xi = ei + c * oi - s * or_;
+        out[k] = xr * xr + xi * xi;
+    }
+}
+
+double PowerSpectrum::total_power() const {
+    double acc = 0.0;
+    for (double d : density) acc += d;
+    return acc * df;
+}
+
+double PowerSpectrum::band_edge(double fraction) const {
+    double target = fraction * total_power(), acc = 0.0;
+    for (size_t k = 0; k < density.size(); ++k) {
+        acc += density[k] * df;
+        if (acc >= target) return frequency(k);
+    }
+    return density.empty() ? 0.0 : frequency(density.size() - 1);
+}
+
+double PowerSpectrum::first_null(double depth_db) const {
+    if (density.size() < 3) return 0.0;
+    double peak = *std::max_element(density.begin(), density.end());
+    double floor = peak * std::pow(10.0, -depth_db / 10.0);
+    for (size_t k = 1; k + 1 < density.size(); ++k)
+        if (density[k] <= floor && density[k] <= density[k - 1] && density[k] <= density[k + 1]) return frequency(k);
+    return 0.0;
+}
+
+namespace {
+
+// periodic Hann: 50%-overlapped copies sum to a constant; returns sum of w^2
+double hann(size_t n, std::vector<double>& w) {
+    w.resize(n);
+    double power = 0.0;
+    for (size_t i = 0; i < n; ++i) {
+        w[i] = 0.5 - 0.5 * std::cos(2.0 * pi * (double)i / (double)n);
+        power += w[i] * w[i];
+    }
+    return power;
+}
+
+void average(const std::vector<double>& sum, std::uint64_t frames, size_t segment, double sample_rate, double window_power,
+             PowerSpectrum& out) {
+    out.df = sample_rate / (double)segment;
+    out.frames = frames;
+    out.density.resize(sum.size());
+    double scale = frames ? 1.0 / ((double)frames * sample_rate * window_power) : 0.0;
+    for (size_t k = 0; k < sum.size(); ++k) {
+        // one-sided: every bin but DC and Nyquist also holds its negative frequency
+        double one_sided = k == 0 || k + 1 == sum.size() ? 1.0 : 2.0;
+        out.density[k] = sum[k] * scale * one_sided;
+    }
+}
+
+} // namespace
+
+WelchEstimator::WelchEstimator(size_t segment, double sample_rate)
+    : plan_(FftPlan::get(segment)), segment_(segment), hop_(segment / 2), sample_rate_(sample_rate) {
+    if (!(sample_rate > 0.0)) throw std::invalid_argument("sample_rate must be positive");
+    window_power_ = hann(segment, window_);
+    buffer_.resize(segment);
+    re_.resize(segment / 2);
+    im_.resize(segment / 2);
+    power_.resize(segment / 2 + 1);
+    sum_.assign(segment / 2 + 1, 0.0);
+}
+
+void WelchEstimator::push(const double* x, size_t n) { push_samples(x, n); }
+void WelchEstimator::push(const float* x, size_t n) { push_samples(x, n); }
+
+template <class T>
+void WelchEstimator::push_samples(const T* x, size_t n) {
+    while (n) {
+        size_t take = std::min(n, segment_ - buffered_);
+        std::copy(x, x + take, buffer_.begin() + buffered_);
+        buffered_ += take;
+        x += take;
+        n -= take;
+        if (buffered_ == segment_) {
+            frame();
+            // the second half is the first half of the next segment
+            std::copy(buffer_.begin() + hop_, buffer_.end(), buffer_.begin());
+            buffered_ = segment_ - hop_;
+        }
+    }
+}
+
+void WelchEstimator::frame() {
+    plan_->power(buffer_.data(), window_.data(), re_.data(), im_.data(), power_.data());
+    for (size_t k = 0; k < sum_.size(); ++k) sum_[k] += power_[k];
+    ++frames_;
+}
+
+void WelchEstimator::reset() {
+    std::fill(sum_.begin(), sum_.end(), 0.0);
+    buffered_ = 0;
+    frames_ = 0;
+}
+
+void WelchEstimator::result(PowerSpectrum& out) const {
+    average(sum_, frames_, segment_, sample_rate_, window_power_, out);
+}
+
+PowerSpectrum WelchEstimator::result() const {
+    PowerSpectrum out;
+    result(out);
+    return out;
+}
+
+void welch_psd(const RunLengthSignal& signal, size_t segment, PowerSpectrum& out, ThreadPool& pool,
+               const std::function<void(double)>& progress) {
+    DSG_PROFILE_SCOPE(prof, "welch_psd");
+    double sample_rate = 1.0 / signal.dt;
+    if (signal.count < segment) {
+        WelchEstimator welch(segment, sample_rate);
+        std::vector<double> padded(segment, 0.0);
+        signal.sample(0, (size_t)signal.count, padded.data());
+        welch.push(padded.data(), segment);
+        welch.result(out);
+        return;
+    }
+    auto plan = FftPlan::get(segment);
+    std::vector<double> window;
+    double window_power = hann(segment, window);
+    size_t hop = segment / 2, bins = segment / 2 + 1;
+    std::uint64_t frames = (signal.count - segment) / hop + 1;
+    // fixed frame blocks summed in block order: the result does not depend on the thread count
+    std::uint64_t per_task = std::max<std::uint64_t>(32, (frames + 1023) / 1024);
+    size_t tasks = (size_t)((frames + per_task - 1) / per_task);
+    std::vector<double> sums(tasks * bins, 0.0);
+    std::atomic<size_t> done{0};
+    std::atomic<bool> stop{false};
+    pool.parallel_for(tasks, [&](size_t t) {
+        if (stop.load(std::memory_order_relaxed)) return;
+        std::uint64_t f0 = t * per_task, f1 = std::min(frames, f0 + per_task);
+        // the frames of a block overlap: expand their samples from the runs once
+        std::vector<double> samples((size_t)(f1 - f0 + 1) * hop), re(hop), im(hop), power(bins);
+        signal.sample(f0 * hop, samples.size(), samples.data());
+        double* sum = sums.data() + t * bins;
+        for (std::uint64_t f = f0; f < f1; ++f) {
+            plan->power(samples.data() + (f - f0) * hop, window.data(), re.data(), im.data(), power.data());
+            for (size_t k = 0; k < bins; ++k) sum[k] += power[k];
+        }
+        if (progress) {
+            try {
+                progress((double)(done.fetch_add(1, std::memory_order_relaxed) + 1) / (double)tasks);
+            } catch (...) {
+                stop.store(true, std::memory_order_relaxed);
+                throw;
+            }
+        }
+    });
+    std::vector<double> total(bins, 0.0);
+    for (size_t t = 0; t < tasks; ++t)
+        for (size_t k = 0; k < bins; ++k) total[k] += sums[t * bins + k];
+    average(total, frames, segment, sample_rate, window_power, out);
+    DSG_PROFILE_COUNT(prof, 0, signal.count, 0);
+}
+
+PowerSpectrum welch_psd(const RunLengthSignal& signal, size_t segment, ThreadPool& pool,
+                        const std::function<void(double)>& progress) {
+    PowerSpectrum out;
+    welch_psd(signal, segment, out, pool, progress);
+    return out;
+}
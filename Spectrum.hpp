@@ -0,0 +1,86 @@
+#pragma once
+#include "RunLengthSignal.hpp"
+#include "ThreadPool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Real-input FFT of n = 2^k points (n >= 4), computed as a complex radix-2 FFT of n/2
+// points on split re / im arrays plus one split pass. The bit-reversal table and all
+// twiddles are built once per size and shared: get() returns the cached plan.
+class FftPlan {
+public:
+    static std::shared_ptr<const FftPlan> get(size_t n);   // thread-safe
+
+    size_t size() const { return n_; }
+    // |X[k]|^2 for k = 0..n/2 of the real frame x[i] * window[i], i < n.
+    // re / im are n/2 doubles of scratch each; out has n/2 + 1 entries.
+    void power(const double* x, const double* window, double* re, double* im, double* out) const;
+    // in-place complex FFT of n/2 points whose input is already in bit-reversed order
+    void transform(double* re, double* im) const;
+    // position of element i of the complex input in bit-reversed order
+    std::uint32_t bit_reversed(size_t i) const { return bitrev_[i]; }
+
+    explicit FftPlan(size_t n);   // use get(); public for make_shared
+
+private:
+    size_t n_;
+    std::vector<std::uint32_t> bitrev_;   // n/2 entries
+    std::vector<double> wr_, wi_;         // stage with half-size h at offset h - 1: exp(-i*pi*j/h)
+    std::vector<double> sr_, si_;         // split pass: cos / sin(2*pi*k/n), k < n/2
+};
+
+// One-sided power spectral density, bins k*df for k = 0..segment/2. density is in
+// signal units^2 per unit of frequency (V^2/Hz for volts over seconds), so summing
+// density * df gives the mean power.
+struct PowerSpectrum {
+    double df = 0.0;
+    std::vector<double> density;
+    std::uint64_t frames = 0;
+
+    double frequency(size_t k) const { return (double)k * df; }
+    double total_power() const;
+    // lowest frequency below which `fraction` of the power lies
+    double band_edge(double fraction) const;
+    // first local minimum above DC at least depth_db below the peak, or 0 if none
+    double first_null(double depth_db = 20.0) const;
+};
+
+// Welch estimator: Hann-windowed segments with 50% overlap, periodograms averaged.
+// Samples are pushed in any chunking; only one segment is buffered.
+class WelchEstimator {
+public:
+    WelchEstimator(size_t segment, double sample_rate);   // segment: power of two >= 4
+
+    void push(const double* x, size_t n);
+    void push(const float* x, size_t n);
+    void reset();
+    std::uint64_t frames() const { return frames_; }
+    // the average so far; zero density before the first full segment
+    void result(PowerSpectrum& out) const;
+    PowerSpectrum result() const;
+
+private:
+    template <class T> void push_samples(const T* x, size_t n);
+    void frame();
+
+    std::shared_ptr<const FftPlan> plan_;
+    size_t segment_, hop_;
+    double sample_rate_;
+    double window_power_;                 // sum of window^2
+    std::vector<double> window_, buffer_, re_, im_, power_, sum_;
+    size_t buffered_ = 0;
+    std::uint64_t frames_ = 0;
+};
+
+// Welch PSD of a run-length signal (sample rate 1 / dt) on the pool: fixed blocks of
+// frames expanded lazily from the runs, summed in block order so any thread count gives
+// the same spectrum. A signal shorter than one segment is zero-padded to it.
+// progress(fraction) is called from the worker threads after each block; an exception
+// it throws (e.g. BackgroundJob::Cancelled) stops the estimate and is rethrown.
+void welch_psd(const RunLengthSignal& signal, size_t segment, PowerSpectrum& out, ThreadPool& pool = ThreadPool::shared(),
+               const std::function<void(double)>& progress = {});
+PowerSpectrum welch_psd(const RunLengthSignal& signal, size_t segment, ThreadPool& pool = ThreadPool::shared(),
+                        const std::function<void(double)>& progress = {});
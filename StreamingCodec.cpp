@@ -0,0 +1,116 @@
+#include "StreamingCodec.hpp"
+#include "SimdKernels.hpp"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+StreamEncoder::StreamEncoder(LineCode code, int sampling_rate)
+    : code_(code), sampling_rate_(sampling_rate), spb_(::samples_per_bit(code, sampling_rate)), level_(initial_level(code)) {
+    if (spb_ <= 0) throw std::invalid_argument("sampling_rate too small for line code");
+    encode_d_ = kernels::select_encoder<double>(code, (size_t)spb_);
+    encode_f_ = kernels::select_encoder<float>(code, (size_t)spb_);
+    encode_i8_ = kernels::select_encoder<std::int8_t>(code, (size_t)spb_);
+}
+
+void StreamEncoder::reset() {
+    level_ = initial_level(code_);
+    bits_ = 0;
+}
+
+template <class T>
+size_t StreamEncoder::encode_range(const BitStream& bits, size_t first, size_t count, T* out, size_t capacity,
+                                   kernels::EncodeFn<T> fn) {
+    count = std::min({count, bits.size() - std::min(first, bits.size()), capacity / spb_});
+    fn(bits, first, count, out, (size_t)spb_, level_);
+    bits_ += count;
+    return count;
+}
+
+size_t StreamEncoder::encode(const BitStream& bits, size_t first, size_t count, double* out, size_t capacity) {
+    return encode_range(bits, first, count, out, capacity, encode_d_);
+}
+
+size_t StreamEncoder::encode(const BitStream& bits, size_t first, size_t count, float* out, size_t capacity) {
+    return encode_range(bits, first, count, out, capacity, encode_f_);
+}
+
+size_t StreamEncoder::encode(const BitStream& bits, size_t first, size_t count, std::int8_t* out, size_t capacity) {
+    return encode_range(bits, first, count, out, capacity, encode_i8_);
+}
+
+size_t StreamEncoder::encode(const std::string& bits, double* out, size_t capacity) {
+    size_t count = std::min(bits.size(), capacity / spb_);
+    BitStream packed(bits.substr(0, count));
+    return encode_range(packed, 0, count, out, capacity, encode_d_);
+}
+
+template <class T>
+BasicStreamDecoder<T>::BasicStreamDecoder(LineCode code, int sampling_rate)
+    : code_(code), sampling_rate_(sampling_rate), decide_(kernels::select_decider(code)) {
+    if (sampling_rate <= 0) throw std::invalid_argument("sampling_rate must be positive");
+}
+
+template <class T>
+void BasicStreamDecoder<T>::reset() {
+    pending_ = 0;
+    have_level_ = false;
+    bits_ = 0;
+}
+
+void decide_bits(LineCode code, int sampling_rate, const double* first, const double* second, size_t n,
+                 double& last_level, BitStream& out) {
+    kernels::select_decider(code)((size_t)sampling_rate, first, second, n, last_level, out);
+}
+
+// Decodes `count` consecutive windows of sampling_rate samples starting at w.
+template <class T>
+void BasicStreamDecoder<T>::decode_windows(const T* w, size_t count, BitStream& out) {
+    constexpr size_t block = 256;
+    double first[block], second[block];
+    size_t s = (size_t)sampling_rate_;
+    size_t half = s / 2;
+    bool split = splits_bit(code_);
+    for (size_t done = 0; done < count; done += block) {
+        size_t n = std::min(block, count - done);
+        const T* p = w + done * s;
+        if (split) {
+            simd::segment_sums(p, n, s, 0, half, first);
+            simd::segment_sums(p, n, s, half, s - half, second);
+        } else {
+            simd::segment_sums(p, n, s, 0, s, first);
+        }
+        decide_(s, first, second, n, last_level_, out);
+    }
+    bits_ += count;
+}
+
+template <class T>
+size_t BasicStreamDecoder<T>::decode(const T* samples, size_t n, BitStream& out) {
+    if (n == 0) return 0;
+    // the batch NRZ-I decoder compares the first bit against the very first sample
+    if (!have_level_) { last_level_ = reference_level(code_, samples[0]); have_level_ = true; }
+    size_t s = (size_t)sampling_rate_;
+    size_t before = bits_;
+    size_t i = 0;
+    if (pending_) {
+        size_t take = std::min(n, s - pending_);
+        std::copy(samples, samples + take, window_.begin() + pending_);
+        pending_ += take;
+        i = take;
+        if (pending_ < s) return 0;
+        decode_windows(window_.data(), 1, out);
+        pending_ = 0;
+    }
+    size_t full = (n - i) / s;
+    decode_windows(samples + i, full, out);
+    i += full * s;
+    // the partial-window buffer is only allocated once a window actually straddles calls
+    if (i < n && window_.empty()) window_.resize(s);
+    std::copy(samples + i, samples + n, window_.begin());
+    pending_ = n - i;
+    return bits_ - before;
+}
+
+template class BasicStreamDecoder<double>;
+template class BasicStreamDecoder<float>;
+template class BasicStreamDecoder<std::int8_t>;
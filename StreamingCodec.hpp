@@ -0,0 +1,114 @@
+#pragma once
+#include "BitStream.hpp"
+#include "LineCode.hpp"
+#include "LineCodeKernels.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Chunked line encoder. Carries the inter-bit state (NRZ-I / Diff Manchester level,
+// AMI last mark) across calls and writes into caller-provided buffers, so an
+// unbounded bit stream can be encoded with constant memory. Feeding a stream in
+// any chunking produces exactly the samples of the whole-string encoders. The
+// per-code (and common samples-per-bit) kernel is picked once at construction.
+class StreamEncoder {
+public:
+    StreamEncoder(LineCode code, int sampling_rate);
+
+    LineCode code() const { return code_; }
+    int samples_per_bit() const { return spb_; }
+    size_t bits_encoded() const { return bits_; }
+    double level() const { return level_; }
+
+    // Encodes bits [first, first+count) of `bits` into `out`. Only whole bits that
+    // fit in `capacity` samples are written; returns the number of bits consumed
+    // (samples written = consumed * samples_per_bit()).
+    size_t encode(const BitStream& bits, size_t first, size_t count, double* out, size_t capacity);
+    size_t encode(const BitStream& bits, size_t first, size_t count, float* out, size_t capacity);
+    size_t encode(const BitStream& bits, size_t first, size_t count, std::int8_t* out, size_t capacity);
+    size_t encode(const BitStream& bits, double* out, size_t capacity) { return encode(bits, 0, bits.size(), out, capacity); }
+    size_t encode(const BitStream& bits, float* out, size_t capacity) { return encode(bits, 0, bits.size(), out, capacity); }
+    size_t encode(const BitStream& bits, std::int8_t* out, size_t capacity) { return encode(bits, 0, bits.size(), out, capacity); }
+    size_t encode(const std::string& bits, double* out, size_t capacity);
+
+    void reset();
+    // Starts the stream mid-way with a known carried level (see ParallelCodec).
+    void set_level(double level) { level_ = level; }
+
+private:
+    template <class T> size_t encode_range(const BitStream& bits, size_t first, size_t count, T* out, size_t capacity,
+                                           kernels::EncodeFn<T> fn);
+
+    LineCode code_;
+    int sampling_rate_;
+    int spb_;
+    double level_;
+    kernels::EncodeFn<double> encode_d_;
+    kernels::EncodeFn<float> encode_f_;
+    kernels::EncodeFn<std::int8_t> encode_i8_;
+    size_t bits_ = 0;
+};
+
+// Bit decisions shared by every decoder representation. For the Manchester codes
+// first/second hold the sums of the two half windows (sampling_rate/2 and the
+// rest); otherwise first holds the whole-window sums and second is unused.
+// last_level is the NRZ-I reference level (previous window average) or the Diff
+// Manchester one (previous second-half average), updated as bits are decided.
+void decide_bits(LineCode code, int sampling_rate, const double* first, const double* second, size_t n,
+                 double& last_level, BitStream& out);
+
+inline bool splits_bit(LineCode code) {
+    return code == LineCode::Manchester || code == LineCode::DifferentialManchester;
+}
+
+// Default decision reference before the first window (see decide_bits).
+inline double reference_level(LineCode code, double first_sample) {
+    return code == LineCode::DifferentialManchester ? initial_level(code) : first_sample;
+}
+
+// Chunked decoder matching the DigitalSignalGenerator::decode_* heuristics. Samples
+// may arrive in arbitrary chunk sizes; an incomplete bit window (fewer than
+// sampling_rate samples) is held internally until the next call. Complete windows
+// are reduced in blocks with the SIMD kernels from SimdKernels.hpp.
+// Instantiated for double, float and int8 samples; int8 windows are summed exactly
+// with integer SIMD.
+template <class T>
+class BasicStreamDecoder {
+public:
+    BasicStreamDecoder(LineCode code, int sampling_rate);
+
+    LineCode code() const { return code_; }
+    size_t bits_decoded() const { return bits_; }
+    size_t pending_samples() const { return pending_; }
+
+    // Consumes `n` samples and appends every completed bit to `out`;
+    // returns the number of bits appended.
+    size_t decode(const T* samples, size_t n, BitStream& out);
+
+    void reset();
+    // Reference level for the first window: NRZ-I the average of the window before
+    // it (default: the first sample seen, as in the batch decoder), Diff Manchester
+    // the average of its second half (default: the encoder's initial level).
+    void set_reference_level(double level) { last_level_ = level; have_level_ = true; }
+
+private:
+    void decode_windows(const T* w, size_t count, BitStream& out);
+
+    LineCode code_;
+    int sampling_rate_;
+    kernels::DecideFn decide_;
+    std::vector<T> window_;        // partial window, allocated on first use
+    size_t pending_ = 0;
+    bool have_level_ = false;
+    double last_level_ = 0.0;
+    size_t bits_ = 0;
+};
+
+using StreamDecoder = BasicStreamDecoder<double>;
+using StreamDecoderF = BasicStreamDecoder<float>;
+using StreamDecoderI8 = BasicStreamDecoder<std::int8_t>;
+
+extern template class BasicStreamDecoder<double>;
+extern template class BasicStreamDecoder<float>;
+extern template class BasicStreamDecoder<std::int8_t>;
@@ -0,0 +1,84 @@
+#include "ThreadPool.hpp"
+#include <algorithm>
+
+static thread_local bool t_in_pool_task = false;
+
+ThreadPool::ThreadPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 1; i < threads; ++i) workers_.emplace_back([this] { worker_loop(); });
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        stop_ = true;
+    }
+    wake_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+ThreadPool& ThreadPool::shared() {
+    static ThreadPool pool;
+    return pool;
+}
+
+void ThreadPool::run_tasks() {
+    std::unique_lock<std::mutex> lk(m_);
+    while (next_ < tasks_) {
+        size_t i = next_++;
+        const auto* fn = fn_;
+        lk.unlock();
+        t_in_pool_task = true;
+        try {
+            (*fn)(i);
+        } catch (...) {
+            std::lock_guard<std::mutex> g(m_);
+            if (!error_) error_ = std::current_exception();
+        }
+        t_in_pool_task = false;
+        lk.lock();
+        if (++finished_ == tasks_) done_.notify_all();
+    }
+}
+
+void ThreadPool::worker_loop() {
+    unsigned seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            wake_.wait(lk, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        run_tasks();
+    }
+}
+
+void ThreadPool::parallel_for(size_t tasks, const std::function<void(size_t)>& fn) {
+    if (tasks == 0) return;
+    if (t_in_pool_task || workers_.empty() || tasks == 1) {
+        for (size_t i = 0; i < tasks; ++i) fn(i);
+        return;
+    }
+    std::lock_guard<std::mutex> submit(submit_);
+    {
+        std::lock_guard<std::mutex> lk(m_);
+        fn_ = &fn;
+        tasks_ = tasks;
+        next_ = 0;
+        finished_ = 0;
+        error_ = nullptr;
+        ++generation_;
+    }
+    wake_.notify_all();
+    run_tasks();
+    std::exception_ptr err;
+    {
+        std::unique_lock<std::mutex> lk(m_);
+        done_.wait(lk, [&] { return finished_ == tasks_; });
+        fn_ = nullptr;
+        tasks_ = 0;
+        err = error_;
+    }
+    if (err) std::rethrow_exception(err);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed-size worker pool for data-parallel loops. parallel_for() hands out task
+// indices from a shared counter; the calling thread works too. Calls made from
+// inside a task run inline, so nested use cannot deadlock.
+class ThreadPool {
+public:
+    explicit ThreadPool(unsigned threads = 0); // 0 = std::thread::hardware_concurrency()
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // worker threads plus the calling thread
+    unsigned concurrency() const { return (unsigned)workers_.size() + 1; }
+
+    // Runs fn(i) for every i in [0, tasks) and returns when all are done.
+    // The first exception thrown by a task is rethrown here.
+    void parallel_for(size_t tasks, const std::function<void(size_t)>& fn);
+
+    static ThreadPool& shared();
+
+private:
+    void worker_loop();
+    void run_tasks();
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_;            // one parallel_for at a time
+    std::mutex m_;
+    std::condition_variable wake_, done_;
+    const std::function<void(size_t)>* fn_ = nullptr;
+    size_t tasks_ = 0, next_ = 0, finished_ = 0;
+    unsigned generation_ = 0;
+    bool stop_ = false;
+    std::exception_ptr error_;
+};
@@ -0,0 +1,527 @@
+#include "BerSweep.hpp"
+#include "DigitalSignalGenerator.hpp"
+#include "EncodeCache.hpp"
+#include "MinMaxPyramid.hpp"
+#include "Palindrome.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
+#include "Spectrum.hpp"
+#include "ThreadPool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+// Throughput benchmark for every encoder / decoder of DigitalSignalGenerator.
+// Prints one line per (operation, input size): bits/s, samples/s and peak RSS.
+
+namespace {
+
+struct Options {
+    size_t min_bits = 1000;
+    size_t max_bits = 100000000;
+    int sampling_rate = 10;
+    double max_memory_mb = 2048.0;
+    double min_time = 0.25;
+    std::string filter;
+    std::string simd;
+    std::string trace;
+};
+
+// Peak resident set size in MiB. On Linux the high-water mark is reset before
+// every case so the figure belongs to that case; elsewhere it is process-wide.
+void reset_peak_rss() {
+#if defined(__linux__)
+    if (FILE* f = std::fopen("/proc/self/clear_refs", "w")) {
+        std::fputs("5", f);
+        std::fclose(f);
+    }
+#endif
+}
+
+double peak_rss_mb() {
+#if defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc))) return pmc.PeakWorkingSetSize / (1024.0 * 1024.0);
+    return 0.0;
+#else
+#if defined(__linux__)
+    if (FILE* f = std::fopen("/proc/self/status", "r")) {
+        char line[256];
+        long kb = -1;
+        while (std::fgets(line, sizeof(line), f)) {
+            if (std::strncmp(line, "VmHWM:", 6) == 0) { kb = std::atol(line + 6); break; }
+        }
+        std::fclose(f);
+        if (kb >= 0) return kb / 1024.0;
+    }
+#endif
+    struct rusage ru;
+    getrusage(RUSAGE_SELF, &ru);
+#if defined(__APPLE__)
+    return ru.ru_maxrss / (1024.0 * 1024.0);
+#else
+    return ru.ru_maxrss / 1024.0;
+#endif
+#endif
+}
+
+BitStream random_bits(size_t n, unsigned seed) {
+    std::mt19937_64 rng(seed);
+    BitStream s;
+    s.reserve(n);
+    for (size_t i = 0; i < n; i += 64) s.append(rng(), (unsigned)std::min<size_t>(64, n - i));
+    return s;
+}
+
+std::vector<double> sine(size_t n) {
+    std::vector<double> v(n);
+    for (size_t i = 0; i < n; ++i) v[i] = std::sin(2.0 * M_PI * (double)i / 50.0);
+    return v;
+}
+
+struct Case {
+    const char* name;
+    // samples produced (encoders) or consumed (decoders) per input bit
+    std::function<double(const DigitalSignalGenerator&)> samples_per_bit;
+    // rough working-set estimate in bytes, used to skip sizes that will not fit
+    std::function<double(const DigitalSignalGenerator&, size_t)> bytes;
+    // builds the input for n bits (not timed) and returns the timed body
+    std::function<std::function<void()>(const DigitalSignalGenerator&, size_t)> prepare;
+};
+
+double dense_bytes(const DigitalSignalGenerator& g, size_t n) { return 2.0 * 8.0 * 1.5 * (double)n * g.sampling_rate + n / 8.0; }
+double signal_bytes(const DigitalSignalGenerator& g, size_t n) { return 2.0 * 8.0 * (double)n * g.sampling_rate + n / 4.0; }
+
+template <class Fn>
+Case encoder(const char* name, Fn fn, bool half_bits) {
+    return {name,
+        [half_bits](const DigitalSignalGenerator& g) { return half_bits ? 2.0 * (g.sampling_rate / 2) : (double)g.sampling_rate; },
+        dense_bytes,
+        [fn](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 1));
+            return [&g, fn, bits]() { auto r = fn(g, *bits); (void)r; };
+        }};
+}
+
+template <class Enc, class Dec>
+Case decoder(const char* name, Enc enc, Dec dec) {
+    return {name,
+        [](const DigitalSignalGenerator& g) { return (double)g.sampling_rate; },
+        signal_bytes,
+        [enc, dec](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto signal = std::make_shared<std::vector<double>>(enc(g, random_bits(n, 2)).second);
+            return [&g, dec, signal]() { auto r = dec(g, *signal); (void)r; };
+        }};
+}
+
+// float32 sample path: encode_f32 + decode(LineCode, std::vector<float>)
+Case decoder_f32(const char* name, LineCode code) {
+    return {name,
+        [](const DigitalSignalGenerator& g) { return (double)g.sampling_rate; },
+        [](const DigitalSignalGenerator& g, size_t n) { return 4.0 * (double)n * g.sampling_rate + n / 4.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto signal = std::make_shared<std::vector<float>>(g.encode_f32(code, random_bits(n, 2)).samples);
+            return [&g, code, signal]() { auto r = g.decode(code, *signal); (void)r; };
+        }};
+}
+
+// multi-core encode / decode through the shared thread pool
+Case encoder_parallel(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [](const DigitalSignalGenerator& g, size_t n) { return 8.0 * (double)n * g.sampling_rate + n / 8.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 1));
+            return [&g, code, bits]() { auto r = g.encode_parallel(code, *bits); (void)r; };
+        }};
+}
+
+Case decoder_parallel(const char* name, LineCode code) {
+    return {name,
+        [](const DigitalSignalGenerator& g) { return (double)g.sampling_rate; },
+        [](const DigitalSignalGenerator& g, size_t n) { return 8.0 * (double)n * g.sampling_rate + n / 4.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto signal = std::make_shared<std::vector<double>>(g.encode(code, random_bits(n, 2)).samples);
+            return [&g, code, signal]() { auto r = g.decode_parallel(code, *signal); (void)r; };
+        }};
+}
+
+// run-length representation: samples/s counts the samples the runs stand for
+Case encoder_runs(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [](const DigitalSignalGenerator&, size_t n) { return 2.0 * 12.0 * 2.0 * n; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 1));
+            return [&g, code, bits]() { auto r = g.encode_runs(code, *bits); (void)r; };
+        }};
+}
+
+// GUI editing: alternately drop and re-append the last 64 bits, so each call resumes
+// from a checkpoint near the end instead of re-encoding the whole input
+Case encoder_cached_append(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [](const DigitalSignalGenerator&, size_t n) { return 2.0 * 12.0 * 2.0 * n + 2.0 * n / 8.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto inputs = std::make_shared<std::vector<BitStream>>();
+            inputs->push_back(random_bits(n, 1));
+            inputs->push_back(inputs->back().substr(0, n > 64 ? n - 64 : 0));
+            auto cache = std::make_shared<EncodeCache>();
+            auto flip = std::make_shared<size_t>(0);
+            cache->encode((*inputs)[0], code, g.bit_duration, g.sampling_rate);
+            return [&g, code, inputs, cache, flip]() {
+                *flip ^= 1;
+                const RunLengthSignal& r = cache->encode((*inputs)[*flip], code, g.bit_duration, g.sampling_rate);
+                (void)r;
+            };
+        }};
+}
+
+Case decoder_runs(const char* name, LineCode code) {
+    return {name,
+        [](const DigitalSignalGenerator& g) { return (double)g.sampling_rate; },
+        [](const DigitalSignalGenerator&, size_t n) { return 12.0 * 2.0 * n + n / 8.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto runs = std::make_shared<RunLengthSignal>(g.encode_runs(code, random_bits(n, 2)));
+            return [&g, code, runs]() { auto r = g.decode(code, *runs); (void)r; };
+        }};
+}
+
+// encode / decode into buffers reused across iterations (no allocation after the first)
+Case encoder_reuse(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [](const DigitalSignalGenerator& g, size_t n) { return 8.0 * (double)n * g.sampling_rate + n / 8.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 1));
+            auto out = std::make_shared<SampledSignal>();
+            return [&g, code, bits, out]() { g.encode(code, *bits, *out); };
+        }};
+}
+
+Case decoder_reuse(const char* name, LineCode code) {
+    return {name,
+        [](const DigitalSignalGenerator& g) { return (double)g.sampling_rate; },
+        [](const DigitalSignalGenerator& g, size_t n) { return 8.0 * (double)n * g.sampling_rate + n / 4.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto signal = std::make_shared<std::vector<double>>(g.encode(code, random_bits(n, 2)).samples);
+            auto out = std::make_shared<BitStream>();
+            return [&g, code, signal, out]() { g.decode(code, *signal, *out); };
+        }};
+}
+
+// int8 ternary samples (one byte per sample, integer window sums), buffers reused
+Case encoder_i8(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [](const DigitalSignalGenerator& g, size_t n) { return 1.0 * (double)n * g.sampling_rate + n / 8.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 1));
+            auto out = std::make_shared<SampledSignalI8>();
+            return [&g, code, bits, out]() { g.encode(code, *bits, *out); };
+        }};
+}
+
+Case decoder_i8(const char* name, LineCode code) {
+    return {name,
+        [](const DigitalSignalGenerator& g) { return (double)g.sampling_rate; },
+        [](const DigitalSignalGenerator& g, size_t n) { return 1.0 * (double)n * g.sampling_rate + n / 4.0; },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto signal = std::make_shared<std::vector<std::int8_t>>(g.encode_i8(code, random_bits(n, 2)).samples);
+            auto out = std::make_shared<BitStream>();
+            return [&g, code, signal, out]() { g.decode(code, *signal, *out); };
+        }};
+}
+
+// plot pyramid built from runs (one Generate); samples/s counts the samples covered
+Case pyramid_build(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [code](const DigitalSignalGenerator& g, size_t n) {
+            return 12.0 * 2.0 * n + 2.0 * 2.0 * n * samples_per_bit(code, g.sampling_rate) / MinMaxPyramid::base_bucket;
+        },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto runs = std::make_shared<RunLengthSignal>(g.encode_runs(code, random_bits(n, 1)));
+            return [runs]() { MinMaxPyramid p; p.build(*runs); };
+        }};
+}
+
+// Welch PSD (4096-point segments) of the runs, as the GUI computes it on Generate
+Case psd(const char* name, LineCode code) {
+    return {name,
+        [code](const DigitalSignalGenerator& g) { return (double)samples_per_bit(code, g.sampling_rate); },
+        [](const DigitalSignalGenerator& g, size_t n) { return 12.0 * 2.0 * n + 1.0 * (1 << 20); },
+        [code](const DigitalSignalGenerator& g, size_t n) -> std::function<void()> {
+            auto runs = std::make_shared<RunLengthSignal>(g.encode_runs(code, random_bits(n, 1)));
+            auto out = std::make_shared<PowerSpectrum>();
+            return [runs, out]() { welch_psd(*runs, 4096, *out); };
+        }};
+}
+
+std::vector<Case> all_cases() {
+    using G = DigitalSignalGenerator;
+    std::vector<Case> cases;
+    using Bits = const BitStream&;
+    using Signal = const std::vector<double>&;
+    auto nrz_l = [](const G& g, Bits b) { return g.nrz_l(b); };
+    auto nrz_i = [](const G& g, Bits b) { return g.nrz_i(b); };
+    auto manchester = [](const G& g, Bits b) { return g.manchester(b); };
+    auto diff_manchester = [](const G& g, Bits b) { return g.differential_manchester(b); };
+    auto ami = [](const G& g, Bits b) { return g.ami(b); };
+    cases.push_back(encoder("nrz_l", nrz_l, false));
+    cases.push_back(encoder("nrz_i", nrz_i, false));
+    cases.push_back(encoder("manchester", manchester, true));
+    cases.push_back(encoder("differential_manchester", diff_manchester, true));
+    cases.push_back(encoder("ami", ami, false));
+    cases.push_back(decoder("decode_nrz_l", nrz_l, [](const G& g, Signal s) { return g.decode_nrz_l_bits(s); }));
+    cases.push_back(decoder("decode_nrz_i", nrz_i, [](const G& g, Signal s) { return g.decode_nrz_i_bits(s); }));
+    cases.push_back(decoder("decode_manchester", manchester, [](const G& g, Signal s) { return g.decode_manchester_bits(s); }));
+    cases.push_back(decoder("decode_differential_manchester", diff_manchester, [](const G& g, Signal s) { return g.decode_differential_manchester_bits(s); }));
+    cases.push_back(decoder("decode_ami", ami, [](const G& g, Signal s) { return g.decode_ami_bits(s); }));
+    cases.push_back(decoder_f32("decode_nrz_l_f32", LineCode::NRZ_L));
+    cases.push_back(decoder_f32("decode_nrz_i_f32", LineCode::NRZ_I));
+    cases.push_back(decoder_f32("decode_manchester_f32", LineCode::Manchester));
+    cases.push_back(decoder_f32("decode_differential_manchester_f32", LineCode::DifferentialManchester));
+    cases.push_back(decoder_f32("decode_ami_f32", LineCode::AMI));
+    cases.push_back(encoder_parallel("nrz_l_parallel", LineCode::NRZ_L));
+    cases.push_back(encoder_parallel("nrz_i_parallel", LineCode::NRZ_I));
+    cases.push_back(encoder_parallel("manchester_parallel", LineCode::Manchester));
+    cases.push_back(encoder_parallel("differential_manchester_parallel", LineCode::DifferentialManchester));
+    cases.push_back(encoder_parallel("ami_parallel", LineCode::AMI));
+    cases.push_back(decoder_parallel("decode_nrz_l_parallel", LineCode::NRZ_L));
+    cases.push_back(decoder_parallel("decode_nrz_i_parallel", LineCode::NRZ_I));
+    cases.push_back(decoder_parallel("decode_manchester_parallel", LineCode::Manchester));
+    cases.push_back(decoder_parallel("decode_differential_manchester_parallel", LineCode::DifferentialManchester));
+    cases.push_back(decoder_parallel("decode_ami_parallel", LineCode::AMI));
+    cases.push_back(encoder_runs("nrz_l_runs", LineCode::NRZ_L));
+    cases.push_back(encoder_runs("nrz_i_runs", LineCode::NRZ_I));
+    cases.push_back(encoder_runs("manchester_runs", LineCode::Manchester));
+    cases.push_back(encoder_runs("differential_manchester_runs", LineCode::DifferentialManchester));
+    cases.push_back(encoder_runs("ami_runs", LineCode::AMI));
+    cases.push_back(encoder_cached_append("manchester_runs_cached_append", LineCode::Manchester));
+    cases.push_back(decoder_runs("decode_nrz_l_runs", LineCode::NRZ_L));
+    cases.push_back(decoder_runs("decode_nrz_i_runs", LineCode::NRZ_I));
+    cases.push_back(decoder_runs("decode_manchester_runs", LineCode::Manchester));
+    cases.push_back(decoder_runs("decode_differential_manchester_runs", LineCode::DifferentialManchester));
+    cases.push_back(decoder_runs("decode_ami_runs", LineCode::AMI));
+    cases.push_back(encoder_reuse("nrz_l_reuse", LineCode::NRZ_L));
+    cases.push_back(encoder_reuse("manchester_reuse", LineCode::Manchester));
+    cases.push_back(decoder_reuse("decode_nrz_l_reuse", LineCode::NRZ_L));
+    cases.push_back(decoder_reuse("decode_manchester_reuse", LineCode::Manchester));
+    cases.push_back(encoder_i8("nrz_l_i8", LineCode::NRZ_L));
+    cases.push_back(encoder_i8("manchester_i8", LineCode::Manchester));
+    cases.push_back(encoder_i8("ami_i8", LineCode::AMI));
+    cases.push_back(decoder_i8("decode_nrz_l_i8", LineCode::NRZ_L));
+    cases.push_back(decoder_i8("decode_manchester_i8", LineCode::Manchester));
+    cases.push_back(decoder_i8("decode_ami_i8", LineCode::AMI));
+    cases.push_back(pyramid_build("plot_pyramid_nrz_l", LineCode::NRZ_L));
+    cases.push_back(pyramid_build("plot_pyramid_manchester", LineCode::Manchester));
+    cases.push_back(psd("psd_nrz_l", LineCode::NRZ_L));
+    cases.push_back(psd("psd_manchester", LineCode::Manchester));
+    // pcm_encode: n output bits from n/8 analog samples
+    cases.push_back({"pcm_encode",
+        [](const G&) { return 1.0 / 8.0; },
+        [](const G&, size_t n) { return 8.0 * n / 8.0 + n / 8.0; },
+        [](const G& g, size_t n) -> std::function<void()> {
+            auto analog = std::make_shared<std::vector<double>>(sine(std::max<size_t>(2, n / 8)));
+            return [&g, analog]() { auto r = g.pcm_encode_bits(*analog, 8); (void)r; };
+        }});
+    // companded PCM: 8 output bits per analog sample
+    auto companded = [](const char* name, Companding law) -> Case {
+        return {name,
+            [](const G&) { return 1.0 / 8.0; },
+            [](const G&, size_t n) { return 8.0 * n / 8.0 + n / 8.0; },
+            [law](const G& g, size_t n) -> std::function<void()> {
+                auto analog = std::make_shared<std::vector<double>>(sine(std::max<size_t>(1, n / 8)));
+                return [&g, analog, law]() { auto r = g.pcm_encode_companded(*analog, law); (void)r; };
+            }};
+    };
+    cases.push_back(companded("pcm_encode_mulaw", Companding::MuLaw));
+    cases.push_back(companded("pcm_encode_alaw", Companding::ALaw));
+    // delta_modulation: one output bit per analog sample
+    cases.push_back({"delta_modulation",
+        [](const G&) { return 1.0; },
+        [](const G&, size_t n) { return 8.0 * n + n / 8.0; },
+        [](const G& g, size_t n) -> std::function<void()> {
+            auto analog = std::make_shared<std::vector<double>>(sine(n));
+            return [&g, analog]() { auto r = g.delta_modulation_bits(*analog, 0.15); (void)r; };
+        }});
+    // scrambling AMI with real bipolar levels, and the descrambling decoder
+    for (Scrambler sc : {Scrambler::B8ZS, Scrambler::HDB3}) {
+        bool b8zs = sc == Scrambler::B8ZS;
+        cases.push_back({b8zs ? "ami_b8zs" : "ami_hdb3",
+            [](const G& g) { return (double)g.sampling_rate; },
+            [](const G& g, size_t n) { return 8.0 * (double)n * g.sampling_rate + n + n / 8.0; },
+            [sc](const G& g, size_t n) -> std::function<void()> {
+                auto bits = std::make_shared<BitStream>(random_bits(n, 3));
+                return [&g, bits, sc]() { auto r = g.encode_ami_scrambled(*bits, sc); (void)r; };
+            }});
+        cases.push_back({b8zs ? "decode_ami_b8zs" : "decode_ami_hdb3",
+            [](const G& g) { return (double)g.sampling_rate; },
+            [](const G& g, size_t n) { return 8.0 * (double)n * g.sampling_rate + 9.0 * n + n / 8.0; },
+            [sc](const G& g, size_t n) -> std::function<void()> {
+                auto signal = std::make_shared<std::vector<double>>(g.encode_ami_scrambled(random_bits(n, 3), sc).samples);
+                return [&g, signal, sc]() { auto r = g.decode_ami_scrambled(*signal, sc); (void)r; };
+            }});
+    }
+    // noisy channel (AWGN + jitter) on float samples, and the whole BER sweep loop
+    cases.push_back({"channel_awgn_jitter",
+        [](const G& g) { return (double)g.sampling_rate; },
+        [](const G& g, size_t n) { return 8.0 * (double)n * g.sampling_rate; },
+        [](const G& g, size_t n) -> std::function<void()> {
+            auto clean = std::make_shared<std::vector<float>>(g.encode_f32(LineCode::NRZ_L, random_bits(n, 3)).samples);
+            auto out = std::make_shared<std::vector<float>>(clean->size());
+            size_t spb = (size_t)g.sampling_rate;
+            return [clean, out, spb]() {
+                ChannelModel ch;
+                ch.ebn0_db = 6.0;
+                ch.jitter = 0.05;
+                apply_channel(ch, clean->data(), clean->size(), spb, 0, out->data());
+            };
+        }});
+    cases.push_back({"ber_sweep_point",
+        [](const G& g) { return (double)g.sampling_rate; },
+        [](const G& g, size_t n) { return 9.0 * 65536.0 * g.sampling_rate * ThreadPool::shared().concurrency(); },
+        [](const G& g, size_t n) -> std::function<void()> {
+            BerSweepConfig cfg;
+            cfg.codes = {LineCode::NRZ_L};
+            cfg.ebn0_min_db = cfg.ebn0_max_db = 6.0;
+            cfg.bits_per_point = n;
+            cfg.sampling_rate = g.sampling_rate;
+            return [cfg]() { auto r = ber_sweep(cfg); (void)r; };
+        }});
+    cases.push_back({"b8zs_scramble",
+        [](const G&) { return 0.0; },
+        [](const G&, size_t n) { return 3.0 * n + 8.0 * n / 4.0; },
+        [](const G& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 3));
+            return [&g, bits]() { auto r = g.b8zs_scramble(*bits); (void)r; };
+        }});
+    cases.push_back({"hdb3_scramble",
+        [](const G&) { return 0.0; },
+        [](const G&, size_t n) { return 3.0 * n + 8.0 * n / 4.0; },
+        [](const G& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 4));
+            return [&g, bits]() { auto r = g.hdb3_scramble(*bits); (void)r; };
+        }});
+    cases.push_back({"longest_palindrome_manacher",
+        [](const G&) { return 0.0; },
+        [](const G&, size_t n) { return 9.0 * n; },
+        [](const G& g, size_t n) -> std::function<void()> {
+            auto bits = std::make_shared<BitStream>(random_bits(n, 5));
+            return [&g, bits]() { auto r = g.longest_palindrome_manacher(*bits); (void)r; };
+        }});
+    // chunked scanner as the CLI runs it: 4 Mi-bit chunks, exact up to 64 Ki bits
+    cases.push_back({"longest_palindrome_chunked",
+        [](const G&) { return 0.0; },
+        [](const G&, size_t n) { return n / 4.0 + 9.0 * std::min<double>((double)n, 4 << 20); },
+        [](const G&, size_t n) -> std::function<void()> {
+            auto chunks = std::make_shared<std::vector<BitStream>>();
+            BitStream bits = random_bits(n, 5);
+            for (size_t i = 0; i < n; i += size_t(4) << 20) chunks->push_back(bits.substr(i, std::min(size_t(4) << 20, n - i)));
+            return [chunks]() {
+                PalindromeScanner scanner(1 << 16);
+                for (const BitStream& c : *chunks) scanner.push(c);
+            };
+        }});
+    return cases;
+}
+
+void usage(const char* argv0) {
+    std::printf("Usage: %s [--min-bits N] [--max-bits N] [--sampling-rate N]\n"
+                "          [--max-memory-mb N] [--min-time SEC] [--filter NAME]\n"
+                "          [--simd scalar|sse2|avx2|avx512] [--trace FILE]\n", argv0);
+}
+
+bool parse(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* v = nullptr;
+        if (a == "--help" || a == "-h") return false;
+        if (!(v = next())) return false;
+        if (a == "--min-bits") opt.min_bits = (size_t)std::atof(v);
+        else if (a == "--max-bits") opt.max_bits = (size_t)std::atof(v);
+        else if (a == "--sampling-rate") opt.sampling_rate = std::atoi(v);
+        else if (a == "--max-memory-mb") opt.max_memory_mb = std::atof(v);
+        else if (a == "--min-time") opt.min_time = std::atof(v);
+        else if (a == "--filter") opt.filter = v;
+        else if (a == "--simd") opt.simd = v;
+        else if (a == "--trace") opt.trace = v;
+        else return false;
+    }
+    return opt.sampling_rate >= 2 && opt.min_bits > 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parse(argc, argv, opt)) { usage(argv[0]); return 1; }
+
+    if (opt.simd == "scalar") simd::set_level(simd::Level::Scalar);
+    else if (opt.simd == "sse2") simd::set_level(simd::Level::SSE2);
+    else if (opt.simd == "avx2") simd::set_level(simd::Level::AVX2);
+    else if (opt.simd == "avx512") simd::set_level(simd::Level::AVX512);
+
+    // stage timers only run when a trace is asked for, so they cannot skew the figures
+    profiler::set_enabled(!opt.trace.empty());
+
+    DigitalSignalGenerator gen(1.0, opt.sampling_rate);
+    using clock = std::chrono::steady_clock;
+
+    std::printf("sampling_rate=%d  max_memory=%.0f MiB  simd=%s  threads=%u\n", opt.sampling_rate, opt.max_memory_mb,
+                simd::level_name(simd::active_level()), ThreadPool::shared().concurrency());
+    std::printf("%-40s %12s %12s %14s %14s %12s\n", "operation", "bits", "time/iter ms", "bits/s", "samples/s", "peak RSS MiB");
+
+    for (const Case& c : all_cases()) {
+        if (!opt.filter.empty() && std::string(c.name).find(opt.filter) == std::string::npos) continue;
+        for (size_t n = opt.min_bits; n <= opt.max_bits; n *= 10) {
+            if (c.bytes(gen, n) > opt.max_memory_mb * 1024.0 * 1024.0) {
+                std::printf("%-40s %12zu %12s\n", c.name, n, "skipped (memory)");
+                continue;
+            }
+            reset_peak_rss();
+            auto body = c.prepare(gen, n);
+            size_t iters = 0;
+            double elapsed = 0.0;
+            auto start = clock::now();
+            do {
+                body();
+                ++iters;
+                elapsed = std::chrono::duration<double>(clock::now() - start).count();
+            } while (elapsed < opt.min_time);
+            double per_iter = elapsed / iters;
+            double bits_per_s = n / per_iter;
+            double samples_per_s = bits_per_s * c.samples_per_bit(gen);
+            std::printf("%-40s %12zu %12.3f %14.4g %14.4g %12.1f\n", c.name, n, per_iter * 1e3, bits_per_s, samples_per_s, peak_rss_mb());
+            std::fflush(stdout);
+        }
+    }
+    if (!opt.trace.empty()) {
+        try {
+            profiler::write_chrome_trace(opt.trace);
+        } catch (const std::exception& e) {
+            std::fprintf(stderr, "error: %s\n", e.what());
+            return 1;
+        }
+    }
+    return 0;
+}
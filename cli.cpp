@@ -0,0 +1,684 @@
+// Headless batch front end: file-to-file encode / decode / scramble / PCM / DM, and
+// BER-vs-Eb/N0 sweeps over the noisy channel model written as CSV.
+// Inputs are memory-mapped and processed in chunks with the streaming codecs, outputs
+// go through large buffered writes, so file size is bounded only by disk space.
+#include "BerSweep.hpp"
+#include "DigitalSignalGenerator.hpp"
+#include "MappedFile.hpp"
+#include "Palindrome.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
+#include "Spectrum.hpp"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string command;
+    std::string input, output;
+    LineCode code = LineCode::NRZ_L;
+    bool code_given = false;
+    Scrambler scrambler = Scrambler::None;
+    int sampling_rate = 100;
+    double bit_duration = 1.0;
+    std::string format = "f32";          // sample output: f32 | i8 | t8 | wav
+    std::string input_format = "f32";    // sample input: f32 | f64 | i8 | t8 | wav
+    bool msb_first = false;              // packed bit order within a byte
+    std::uint64_t bits = 0;              // 0 = the whole input
+    int pcm_bits = 8;
+    bool companded = false;
+    Companding law = Companding::MuLaw;
+    double step = 0.1;
+    std::uint64_t max_palindrome = std::uint64_t(1) << 16;
+    size_t psd_segment = 4096;           // Welch segment, a power of two
+    BerSweepConfig sweep;
+    std::string trace;                   // Chrome trace JSON of the run's stages
+};
+
+// samples per chunk; keeps the working set to a few tens of MiB whatever the file size
+constexpr size_t chunk_samples = size_t(4) << 20;
+
+[[noreturn]] void usage(const char* error = nullptr) {
+    if (error) std::fprintf(stderr, "error: %s\n\n", error);
+    std::fprintf(stderr,
+        "usage: DigitalSignalGeneratorCli <command> -i INPUT -o OUTPUT [options]\n"
+        "commands:\n"
+        "  encode    packed bits -> samples       --code, --scrambler, --format\n"
+        "  decode    samples -> packed bits       --code, --scrambler, --input-format\n"
+        "  scramble  packed bits -> int8 AMI symbols (-1/0/+1, one per bit)  --scrambler\n"
+        "  pcm       analog samples -> packed bits  --pcm-bits N | --companding mulaw|alaw\n"
+        "  dm        analog samples -> packed bits  --step S\n"
+        "  psd       samples -> Welch PSD as CSV (-o - for stdout)  --segment N (power of two, default 4096);\n"
+        "            sample rate is --sampling-rate / --bit-duration\n"
+        "  palindrome  packed bits -> longest palindrome (start, length, bits; -o - for stdout)\n"
+        "            --max-length N: exact up to N bits, memory ~9 bytes/bit of N + chunk (default 65536)\n"
+        "  ber       BER vs Eb/N0 sweep -> CSV (no -i; -o - for stdout); all codes unless --code\n"
+        "            --ebn0-min/--ebn0-max/--ebn0-step dB, --bits-per-point N,\n"
+        "            --attenuation dB, --jitter bit-rms, --seed N (--sampling-rate default 8)\n"
+        "options:\n"
+        "  --code nrz-l|nrz-i|manchester|diff-manchester|ami   (default nrz-l)\n"
+        "  --scrambler none|b8zs|hdb3     AMI zero substitution (default none)\n"
+        "  --sampling-rate N              samples per bit (default 100; even for the Manchester codes)\n"
+        "  --bit-duration D               seconds per bit, sets the WAV rate (default 1)\n"
+        "  --format f32|i8|t8|wav         sample output; i8 is level*127, t8 the level itself\n"
+        "                                 (-1/0/+1, one byte per sample), wav is float32\n"
+        "  --input-format f32|f64|i8|t8|wav  sample input (wav: mono float32 or int16)\n"
+        "  --bit-order lsb|msb            packed bit order within a byte (default lsb)\n"
+        "  --bits N                       use only the first N input bits\n"
+        "  --trace FILE                   write per-stage timings as Chrome trace JSON\n");
+    std::exit(2);
+}
+
+LineCode parse_code(const std::string& v) {
+    if (v == "nrz-l") return LineCode::NRZ_L;
+    if (v == "nrz-i") return LineCode::NRZ_I;
+    if (v == "manchester") return LineCode::Manchester;
+    if (v == "diff-manchester") return LineCode::DifferentialManchester;
+    if (v == "ami") return LineCode::AMI;
+    usage("unknown --code");
+}
+
+Scrambler parse_scrambler(const std::string& v) {
+    if (v == "none") return Scrambler::None;
+    if (v == "b8zs") return Scrambler::B8ZS;
+    if (v == "hdb3") return Scrambler::HDB3;
+    usage("unknown --scrambler");
+}
+
+bool parse_bit_order(const std::string& v) {
+    if (v == "lsb") return false;
+    if (v == "msb") return true;
+    usage("unknown --bit-order");
+}
+
+Companding parse_companding(const std::string& v) {
+    if (v == "mulaw") return Companding::MuLaw;
+    if (v == "alaw") return Companding::ALaw;
+    usage("unknown --companding");
+}
+
+// digits only: stoull alone would accept a sign, leading space or trailing garbage
+std::uint64_t parse_count(const std::string& option, const std::string& v) {
+    if (v.empty() || v.find_first_not_of("0123456789") != std::string::npos) usage(("invalid value for " + option).c_str());
+    try {
+        return std::stoull(v);
+    } catch (const std::out_of_range&) {
+        usage((option + " out of range").c_str());
+    }
+}
+
+// the whole value must parse, and to a finite number
+double parse_double(const std::string& option, const std::string& v) {
+    char* end = nullptr;
+    errno = 0;
+    double x = std::strtod(v.c_str(), &end);
+    if (v.empty() || end != v.c_str() + v.size() || errno == ERANGE || !std::isfinite(x))
+        usage(("invalid value for " + option).c_str());
+    return x;
+}
+
+int parse_int(const std::string& option, const std::string& v) {
+    std::uint64_t n = parse_count(option, v);
+    if (n > (std::uint64_t)INT_MAX) usage((option + " out of range").c_str());
+    return (int)n;
+}
+
+Options parse_args(int argc, char** argv) {
+    if (argc < 2) usage();
+    Options opt;
+    opt.command = argv[1];
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (i + 1 >= argc) usage(("missing value for " + a).c_str());
+        std::string v = argv[++i];
+        if (a == "-i") opt.input = v;
+        else if (a == "-o") opt.output = v;
+        else if (a == "--code") { opt.code = parse_code(v); opt.code_given = true; }
+        else if (a == "--scrambler") opt.scrambler = parse_scrambler(v);
+        else if (a == "--sampling-rate") opt.sampling_rate = opt.sweep.sampling_rate = parse_int(a, v);
+        else if (a == "--bit-duration") opt.bit_duration = parse_double(a, v);
+        else if (a == "--format") opt.format = v;
+        else if (a == "--input-format") opt.input_format = v;
+        else if (a == "--bit-order") opt.msb_first = parse_bit_order(v);
+        else if (a == "--bits") opt.bits = parse_count(a, v);
+        else if (a == "--pcm-bits") opt.pcm_bits = parse_int(a, v);
+        else if (a == "--companding") { opt.companded = true; opt.law = parse_companding(v); }
+        else if (a == "--step") opt.step = parse_double(a, v);
+        else if (a == "--max-length") opt.max_palindrome = parse_count(a, v);
+        else if (a == "--segment") opt.psd_segment = (size_t)parse_count(a, v);
+        else if (a == "--ebn0-min") opt.sweep.ebn0_min_db = parse_double(a, v);
+        else if (a == "--ebn0-max") opt.sweep.ebn0_max_db = parse_double(a, v);
+        else if (a == "--ebn0-step") opt.sweep.ebn0_step_db = parse_double(a, v);
+        else if (a == "--bits-per-point") opt.sweep.bits_per_point = parse_count(a, v);
+        else if (a == "--attenuation") opt.sweep.attenuation_db = parse_double(a, v);
+        else if (a == "--jitter") opt.sweep.jitter = parse_double(a, v);
+        else if (a == "--seed") opt.sweep.seed = parse_count(a, v);
+        else if (a == "--trace") opt.trace = v;
+        else usage(("unknown option " + a).c_str());
+    }
+    if ((opt.input.empty() && opt.command != "ber") || opt.output.empty()) usage("-i and -o are required");
+    if (opt.code_given) opt.sweep.codes = {opt.code};
+    if (opt.sampling_rate <= 0) usage("--sampling-rate must be positive");
+    if (opt.max_palindrome == 0) usage("--max-length must be positive");
+    if (opt.psd_segment < 4 || (opt.psd_segment & (opt.psd_segment - 1))) usage("--segment must be a power of two >= 4");
+    if (!(opt.bit_duration > 0)) usage("--bit-duration must be positive");
+    if (!(opt.step > 0)) usage("--step must be positive");
+    if (!(opt.sweep.ebn0_step_db > 0)) usage("--ebn0-step must be positive");
+    if (opt.sweep.jitter < 0) usage("--jitter must not be negative");
+    if (opt.format != "f32" && opt.format != "i8" && opt.format != "t8" && opt.format != "wav") usage("unknown --format");
+    if (opt.scrambler != Scrambler::None && opt.code != LineCode::AMI && opt.command != "scramble") usage("--scrambler needs --code ami");
+    return opt;
+}
+
+template <class T> void put_le(unsigned char* p, T v) {
+    for (size_t i = 0; i < sizeof(T); ++i) p[i] = (unsigned char)((std::uint64_t)v >> (8 * i));
+}
+
+template <class T> T get_le(const unsigned char* p) {
+    std::uint64_t v = 0;
+    for (size_t i = 0; i < sizeof(T); ++i) v |= (std::uint64_t)p[i] << (8 * i);
+    return (T)v;
+}
+
+// Sample output as raw float32, raw int8 (level * 127), raw ternary int8 (the level)
+// or mono float32 WAV. The WAV sizes are patched in by finish().
+class SampleSink {
+public:
+    // the RIFF and data chunk sizes are 32-bit: 36 + 4 bytes per sample must fit
+    static constexpr std::uint64_t max_wav_samples = (UINT32_MAX - 36) / 4;
+
+    SampleSink(const std::string& path, const std::string& format, double sample_rate)
+        : out_(path), format_(format) {
+        if (format_ == "wav") {
+            unsigned char h[44] = {};
+            std::memcpy(h, "RIFF", 4);
+            std::memcpy(h + 8, "WAVEfmt ", 8);
+            put_le<std::uint32_t>(h + 16, 16);
+            put_le<std::uint16_t>(h + 20, 3);      // IEEE float
+            put_le<std::uint16_t>(h + 22, 1);
+            std::uint32_t rate = (std::uint32_t)std::max(1.0, std::round(sample_rate));
+            put_le<std::uint32_t>(h + 24, rate);
+            put_le<std::uint32_t>(h + 28, rate * 4);
+            put_le<std::uint16_t>(h + 32, 4);
+            put_le<std::uint16_t>(h + 34, 32);
+            std::memcpy(h + 36, "data", 4);
+            out_.write(h, sizeof(h));
+        }
+    }
+
+    void write(const float* x, size_t n) {
+        DSG_PROFILE_SCOPE(prof, "write");
+        DSG_PROFILE_COUNT(prof, 0, n, 0);
+        if (format_ == "wav" && samples_ + n > max_wav_samples)
+            throw std::runtime_error("WAV output exceeds 4 GiB; use --format f32");
+        if (format_ == "i8" || format_ == "t8") {
+            float scale = format_ == "i8" ? 127.0f : 1.0f;
+            i8_.resize(n);
+            for (size_t i = 0; i < n; ++i) i8_[i] = (std::int8_t)std::lround(std::max(-1.0f, std::min(1.0f, x[i])) * scale);
+            out_.write(i8_.data(), n);
+        } else {
+            out_.write(x, n * sizeof(float));
+        }
+        samples_ += n;
+    }
+
+    // ternary samples, written as they are (format t8)
+    void write(const std::int8_t* x, size_t n) {
+        DSG_PROFILE_SCOPE(prof, "write");
+        DSG_PROFILE_COUNT(prof, 0, n, 0);
+        out_.write(x, n);
+        samples_ += n;
+    }
+
+    void finish() {
+        if (format_ == "wav") {
+            unsigned char v[4];
+            put_le<std::uint32_t>(v, (std::uint32_t)(samples_ * 4));
+            out_.write_at(40, v, 4);
+            put_le<std::uint32_t>(v, (std::uint32_t)(36 + samples_ * 4));
+            out_.write_at(4, v, 4);
+        }
+        out_.close();
+    }
+
+    std::uint64_t samples() const { return samples_; }
+
+private:
+    BufferedWriter out_;
+    std::string format_;
+    std::vector<std::int8_t> i8_;
+    std::uint64_t samples_ = 0;
+};
+
+// Packed bit output; whole words are written as they complete.
+class BitSink {
+public:
+    BitSink(const std::string& path, bool msb_first) : out_(path), msb_first_(msb_first) { }
+
+    // writes the complete 64-bit words of bits and keeps the rest in it
+    void drain(BitStream& bits) {
+        size_t full = bits.size() / BitStream::word_bits * BitStream::word_bits;
+        if (full == 0) return;
+        BitStream head = bits.substr(0, full);
+        write_bytes(head);
+        bits = bits.substr(full, bits.size() - full);
+    }
+
+    void finish(BitStream& bits) {
+        write_bytes(bits);
+        bits.clear();
+        out_.close();
+    }
+
+    std::uint64_t bits() const { return bits_; }
+
+private:
+    void write_bytes(const BitStream& bits) {
+        DSG_PROFILE_SCOPE(prof, "write");
+        DSG_PROFILE_COUNT(prof, bits.size(), 0, 0);
+        bytes_.resize((bits.size() + 7) / 8);
+        bits.to_bytes(bytes_.data(), msb_first_);
+        out_.write(bytes_.data(), bytes_.size());
+        bits_ += bits.size();
+    }
+
+    BufferedWriter out_;
+    bool msb_first_;
+    std::vector<unsigned char> bytes_;
+    std::uint64_t bits_ = 0;
+};
+
+// Typed view of the samples in a mapped file: raw f32 / f64 / i8 / t8, or a mono WAV
+// with float32 or int16 data.
+class SampleSource {
+public:
+    SampleSource(const MappedFile& file, const std::string& format) : file_(file) {
+        const unsigned char* p = file.data();
+        size_t size = file.size();
+        if (format == "f32") { type_ = F32; data_ = p; count_ = size / 4; }
+        else if (format == "f64") { type_ = F64; data_ = p; count_ = size / 8; }
+        else if (format == "i8") { type_ = I8; data_ = p; count_ = size; }
+        else if (format == "t8") { type_ = T8; data_ = p; count_ = size; }
+        else if (format == "wav") parse_wav(p, size);
+        else usage("unknown --input-format");
+    }
+
+    size_t count() const { return count_; }
+    // t8 samples straight from the mapping (nullptr for other formats)
+    const std::int8_t* ternary() const { return type_ == T8 ? reinterpret_cast<const std::int8_t*>(data_) : nullptr; }
+
+    template <class T>
+    void read(size_t first, size_t n, T* out) const {
+        DSG_PROFILE_SCOPE(prof, "read");
+        DSG_PROFILE_COUNT(prof, 0, n, 0);
+        switch (type_) {
+            case F32: for (size_t i = 0; i < n; ++i) { float v; std::memcpy(&v, data_ + 4 * (first + i), 4); out[i] = (T)v; } break;
+            case F64: for (size_t i = 0; i < n; ++i) { double v; std::memcpy(&v, data_ + 8 * (first + i), 8); out[i] = (T)v; } break;
+            case I8: for (size_t i = 0; i < n; ++i) out[i] = (T)((std::int8_t)data_[first + i] / 127.0); break;
+            case T8: for (size_t i = 0; i < n; ++i) out[i] = (T)(std::int8_t)data_[first + i]; break;
+            case I16: for (size_t i = 0; i < n; ++i) out[i] = (T)(get_le<std::int16_t>(data_ + 2 * (first + i)) / 32768.0); break;
+        }
+    }
+
+    // lets the kernel drop pages of samples before `sample`
+    void release_before(size_t sample) const {
+        size_t width = type_ == F64 ? 8 : type_ == F32 ? 4 : type_ == I16 ? 2 : 1;
+        size_t offset = (size_t)(data_ - file_.data());
+        file_.release(0, offset + sample * width);
+    }
+
+private:
+    enum Type { F32, F64, I8, T8, I16 };
+
+    void parse_wav(const unsigned char* p, size_t size) {
+        if (size < 12 || std::memcmp(p, "RIFF", 4) != 0 || std::memcmp(p + 8, "WAVE", 4) != 0)
+            throw std::runtime_error("not a WAV file");
+        int fmt = 0, channels = 0, bits = 0;
+        for (size_t off = 12; off + 8 <= size;) {
+            std::uint32_t len = get_le<std::uint32_t>(p + off + 4);
+            const unsigned char* body = p + off + 8;
+            if (std::memcmp(p + off, "fmt ", 4) == 0 && len >= 16) {
+                fmt = get_le<std::uint16_t>(body);
+                channels = get_le<std::uint16_t>(body + 2);
+                bits = get_le<std::uint16_t>(body + 14);
+            } else if (std::memcmp(p + off, "data", 4) == 0) {
+                if (channels != 1) throw std::runtime_error("only mono WAV is supported");
+                if (fmt == 3 && bits == 32) type_ = F32;
+                else if (fmt == 1 && bits == 16) type_ = I16;
+                else throw std::runtime_error("WAV must be float32 or int16 PCM");
+                data_ = body;
+                size_t avail = std::min<size_t>(len, size - (off + 8));
+                count_ = avail / (size_t)(bits / 8);
+                return;
+            }
+            off += 8 + len + (len & 1);
+        }
+        throw std::runtime_error("WAV has no data chunk");
+    }
+
+    const MappedFile& file_;
+    Type type_ = F32;
+    const unsigned char* data_ = nullptr;
+    size_t count_ = 0;
+};
+
+std::uint64_t input_bits(const Options& opt, const MappedFile& in) {
+    std::uint64_t total = (std::uint64_t)in.size() * 8;
+    return opt.bits ? std::min(opt.bits, total) : total;
+}
+
+// bits per chunk: a multiple of 64 so every chunk starts on a byte of the input
+size_t chunk_bits_for(size_t samples_per_bit) {
+    size_t bits = chunk_samples / std::max<size_t>(1, samples_per_bit);
+    return std::max<size_t>(64, bits / 64 * 64);
+}
+
+void report(const char* what, std::uint64_t in, const char* in_unit, std::uint64_t out, const char* out_unit,
+            std::chrono::steady_clock::time_point start) {
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "%s: %llu %s -> %llu %s in %.3f s (%.3g %s/s)\n", what, (unsigned long long)in, in_unit,
+                 (unsigned long long)out, out_unit, s, s > 0 ? (double)in / s : 0.0, in_unit);
+}
+
+int run_encode(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile in(opt.input);
+    std::uint64_t total = input_bits(opt, in);
+    StreamEncoder enc(opt.code, opt.sampling_rate);
+    size_t spb = (size_t)enc.samples_per_bit();
+    // one symbol per bit, scrambled or not: the size is known before anything is written
+    if (opt.format == "wav" && total > SampleSink::max_wav_samples / spb)
+        throw std::invalid_argument("WAV output would exceed 4 GiB (" + std::to_string(total) + " bits at " +
+                                    std::to_string(spb) + " samples per bit); use --format f32");
+    SampleSink sink(opt.output, opt.format, (double)spb / opt.bit_duration);
+    AmiScrambler scrambler(opt.scrambler);
+    size_t chunk = chunk_bits_for(spb);
+    // t8 output is produced as int8 end to end; the other formats go through float
+    bool ternary = opt.format == "t8";
+    std::vector<float> samples;
+    std::vector<std::int8_t> ternary_samples;
+    std::vector<std::int8_t> symbols(chunk + 8);
+    auto write_symbols = [&](size_t n) {
+        if (ternary) {
+            ternary_samples.resize(n * spb);
+            for (size_t i = 0; i < n; ++i) std::fill_n(ternary_samples.begin() + i * spb, spb, symbols[i]);
+            sink.write(ternary_samples.data(), ternary_samples.size());
+            return;
+        }
+        samples.resize(n * spb);
+        for (size_t i = 0; i < n; ++i) std::fill(samples.begin() + i * spb, samples.begin() + (i + 1) * spb, (float)symbols[i]);
+        sink.write(samples.data(), samples.size());
+    };
+    for (std::uint64_t first = 0; first < total; first += chunk) {
+        size_t n = (size_t)std::min<std::uint64_t>(chunk, total - first);
+        DSG_PROFILE_SCOPE(prof, "encode_chunk");
+        DSG_PROFILE_COUNT(prof, n, n * spb, 0);
+        BitStream bits = BitStream::from_bytes(in.data() + first / 8, n, opt.msb_first);
+        if (opt.scrambler != Scrambler::None) {
+            write_symbols(scrambler.push(bits, 0, n, symbols.data()));
+        } else if (ternary) {
+            ternary_samples.resize(n * spb);
+            enc.encode(bits, ternary_samples.data(), ternary_samples.size());
+            sink.write(ternary_samples.data(), ternary_samples.size());
+        } else {
+            samples.resize(n * spb);
+            enc.encode(bits, samples.data(), samples.size());
+            sink.write(samples.data(), samples.size());
+        }
+        in.release(0, (size_t)((first + n) / 8));
+    }
+    if (opt.scrambler != Scrambler::None) write_symbols(scrambler.finish(symbols.data()));
+    sink.finish();
+    report("encode", total, "bits", sink.samples(), "samples", start);
+    return 0;
+}
+
+int run_decode(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile in(opt.input);
+    SampleSource src(in, opt.input_format);
+    size_t s = (size_t)opt.sampling_rate;
+    size_t windows = src.count() / s;
+    size_t chunk = std::max<size_t>(1, chunk_samples / s);
+    StreamDecoderF dec(opt.code, opt.sampling_rate);
+    StreamDecoderI8 dec8(opt.code, opt.sampling_rate);
+    AmiDescrambler descrambler(opt.scrambler);
+    BitSink sink(opt.output, opt.msb_first);
+    BitStream bits;
+    // t8 input is decoded in place from the mapping, with integer window sums
+    const std::int8_t* t8 = src.ternary();
+    std::vector<float> samples(t8 ? 0 : chunk * s);
+    std::vector<double> sums(chunk);
+    std::vector<std::int8_t> symbols(chunk);
+    for (size_t w = 0; w < windows; w += chunk) {
+        size_t n = std::min(chunk, windows - w);
+        DSG_PROFILE_SCOPE(prof, "decode_chunk");
+        DSG_PROFILE_COUNT(prof, n, n * s, 0);
+        bool scrambled = opt.scrambler != Scrambler::None;
+        if (t8) {
+            const std::int8_t* p = t8 + w * s;
+            if (scrambled) simd::segment_sums(p, n, s, 0, s, sums.data());
+            else dec8.decode(p, n * s, bits);
+        } else {
+            src.read(w * s, n * s, samples.data());
+            if (scrambled) simd::segment_sums(samples.data(), n, s, 0, s, sums.data());
+            else dec.decode(samples.data(), n * s, bits);
+        }
+        if (scrambled) {
+            ami_symbols(sums.data(), n, opt.sampling_rate, symbols.data());
+            descrambler.push(symbols.data(), n, bits);
+        }
+        sink.drain(bits);
+        src.release_before((w + n) * s);
+    }
+    if (opt.scrambler != Scrambler::None) descrambler.finish(bits);
+    sink.finish(bits);
+    report("decode", (std::uint64_t)windows * s, "samples", sink.bits(), "bits", start);
+    return 0;
+}
+
+int run_scramble(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    if (opt.scrambler == Scrambler::None) usage("scramble needs --scrambler b8zs|hdb3");
+    MappedFile in(opt.input);
+    std::uint64_t total = input_bits(opt, in);
+    BufferedWriter out(opt.output);
+    AmiScrambler scrambler(opt.scrambler);
+    size_t chunk = chunk_bits_for(1);
+    std::vector<std::int8_t> symbols(chunk + 8);
+    for (std::uint64_t first = 0; first < total; first += chunk) {
+        size_t n = (size_t)std::min<std::uint64_t>(chunk, total - first);
+        DSG_PROFILE_SCOPE(prof, "scramble_chunk");
+        DSG_PROFILE_COUNT(prof, n, 0, 0);
+        BitStream bits = BitStream::from_bytes(in.data() + first / 8, n, opt.msb_first);
+        out.write(symbols.data(), scrambler.push(bits, 0, n, symbols.data()));
+        in.release(0, (size_t)((first + n) / 8));
+    }
+    out.write(symbols.data(), scrambler.finish(symbols.data()));
+    std::uint64_t written = out.bytes_written();
+    out.close();
+    report("scramble", total, "bits", written, "symbols", start);
+    return 0;
+}
+
+// pcm: one min/max pass, then quantize chunk by chunk; dm: one pass
+int run_analog(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile in(opt.input);
+    SampleSource src(in, opt.input_format);
+    size_t total = src.count();
+    bool pcm = opt.command == "pcm";
+    if (total < (pcm ? 2u : 1u)) throw std::invalid_argument("Signal needs at least 2 samples");
+    std::vector<double> x(std::min(total, chunk_samples));
+    BitSink sink(opt.output, opt.msb_first);
+    BitStream bits;
+    if (pcm) {
+        double mn = 0, mx = 0;
+        for (size_t first = 0; first < total; first += x.size()) {
+            size_t n = std::min(x.size(), total - first);
+            src.read(first, n, x.data());
+            double cmn, cmx;
+            simd::min_max(x.data(), n, cmn, cmx);
+            if (first == 0 || cmn < mn) mn = cmn;
+            if (first == 0 || cmx > mx) mx = cmx;
+        }
+        PcmEncoder enc = opt.companded ? PcmEncoder(std::max(std::abs(mn), std::abs(mx)), opt.law)
+                                       : PcmEncoder(mn, mx, opt.pcm_bits);
+        for (size_t first = 0; first < total; first += x.size()) {
+            size_t n = std::min(x.size(), total - first);
+            DSG_PROFILE_SCOPE(prof, "pcm_chunk");
+            DSG_PROFILE_COUNT(prof, 0, n, 0);
+            src.read(first, n, x.data());
+            enc.encode(x.data(), n, bits);
+            sink.drain(bits);
+            src.release_before(first + n);
+        }
+        enc.finish(bits);
+    } else {
+        DeltaModulator dm(opt.step);
+        for (size_t first = 0; first < total; first += x.size()) {
+            size_t n = std::min(x.size(), total - first);
+            DSG_PROFILE_SCOPE(prof, "dm_chunk");
+            DSG_PROFILE_COUNT(prof, 0, n, 0);
+            src.read(first, n, x.data());
+            dm.encode(x.data(), n, bits);
+            sink.drain(bits);
+            src.release_before(first + n);
+        }
+    }
+    sink.finish(bits);
+    report(opt.command.c_str(), total, "samples", sink.bits(), "bits", start);
+    return 0;
+}
+
+// Welch PSD streamed over the mapped samples, one CSV row per frequency bin
+int run_psd(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile in(opt.input);
+    SampleSource src(in, opt.input_format);
+    size_t total = src.count();
+    WelchEstimator welch(opt.psd_segment, opt.sampling_rate / opt.bit_duration);
+    std::vector<double> x(std::min(total, chunk_samples));
+    for (size_t first = 0; first < total; first += x.size()) {
+        size_t n = std::min(x.size(), total - first);
+        DSG_PROFILE_SCOPE(prof, "psd_chunk");
+        DSG_PROFILE_COUNT(prof, 0, n, 0);
+        src.read(first, n, x.data());
+        welch.push(x.data(), n);
+        src.release_before(first + n);
+    }
+    if (welch.frames() == 0) throw std::invalid_argument("input is shorter than one --segment");
+    PowerSpectrum psd = welch.result();
+    std::FILE* out = opt.output == "-" ? stdout : std::fopen(opt.output.c_str(), "w");
+    if (!out) throw std::runtime_error("cannot open " + opt.output);
+    std::fprintf(out, "frequency_hz,frequency_bit_rate,density,density_db\n");
+    for (size_t k = 0; k < psd.density.size(); ++k)
+        std::fprintf(out, "%.9g,%.9g,%.6e,%.3f\n", psd.frequency(k), psd.frequency(k) * opt.bit_duration, psd.density[k],
+                     10.0 * std::log10(std::max(psd.density[k], 1e-300)));
+    if (out != stdout) std::fclose(out);
+    report("psd", total, "samples", psd.frames, "frames", start);
+    return 0;
+}
+
+// chunked Manacher: the stream is never held in memory, only max_length + one chunk
+int run_palindrome(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    MappedFile in(opt.input);
+    std::uint64_t total = input_bits(opt, in);
+    PalindromeScanner scanner(opt.max_palindrome);
+    size_t chunk = chunk_bits_for(1);
+    for (std::uint64_t first = 0; first < total; first += chunk) {
+        size_t n = (size_t)std::min<std::uint64_t>(chunk, total - first);
+        scanner.push(BitStream::from_bytes(in.data() + first / 8, n, opt.msb_first));
+        in.release(0, (size_t)((first + n) / 8));
+    }
+    std::FILE* out = opt.output == "-" ? stdout : std::fopen(opt.output.c_str(), "w");
+    if (!out) throw std::runtime_error("cannot open " + opt.output);
+    const Palindrome& p = scanner.result();
+    std::fprintf(out, "start %llu\nlength %llu\n", (unsigned long long)p.start, (unsigned long long)p.length);
+    if (p.length + 1 >= opt.max_palindrome && p.length > 1)
+        std::fprintf(out, "# at least --max-length - 1 bits: a longer palindrome may exist\n");
+    std::string bits = scanner.result_bits().to_string();
+    std::fprintf(out, "%s\n", bits.c_str());
+    if (out != stdout) std::fclose(out);
+    report("palindrome", total, "bits", p.length, "bits", start);
+    return 0;
+}
+
+int run_ber(const Options& opt) {
+    auto start = std::chrono::steady_clock::now();
+    std::FILE* out = opt.output == "-" ? stdout : std::fopen(opt.output.c_str(), "w");
+    if (!out) throw std::runtime_error("cannot open " + opt.output);
+    std::atomic<int> last{-1};
+    // called from the worker threads
+    auto curves = ber_sweep(opt.sweep, ThreadPool::shared(), [&last](double f) {
+        int pct = (int)(f * 100.0);
+        if (last.exchange(pct) != pct) std::fprintf(stderr, "\r%3d%%", pct);
+    });
+    std::fprintf(stderr, "\r");
+    std::fprintf(out, "code,ebn0_db,bits,errors,ber,antipodal_ber\n");
+    for (const BerCurve& c : curves)
+        for (const BerPoint& p : c.points)
+            std::fprintf(out, "%s,%g,%llu,%llu,%.6e,%.6e\n", line_code_name(c.code), p.ebn0_db, (unsigned long long)p.bits,
+                         (unsigned long long)p.errors, p.ber(), ber_antipodal(p.ebn0_db));
+    if (out != stdout) std::fclose(out);
+    std::uint64_t simulated = curves.empty() ? 0 : (std::uint64_t)curves.size() * curves[0].points.size() * opt.sweep.bits_per_point;
+    double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::fprintf(stderr, "ber: %llu simulated bits in %.3f s (%.3g bits/s)\n", (unsigned long long)simulated, s,
+                 s > 0 ? (double)simulated / s : 0.0);
+    return 0;
+}
+
+int run(const Options& opt) {
+    if (opt.command == "encode") return run_encode(opt);
+    if (opt.command == "decode") return run_decode(opt);
+    if (opt.command == "scramble") return run_scramble(opt);
+    if (opt.command == "pcm" || opt.command == "dm") return run_analog(opt);
+    if (opt.command == "ber") return run_ber(opt);
+    if (opt.command == "palindrome") return run_palindrome(opt);
+    if (opt.command == "psd") return run_psd(opt);
+    usage("unknown command");
+}
+
+// per-stage totals on stderr, then the events as Chrome trace JSON
+void write_trace(const std::string& path) {
+    if (!profiler::compiled_in) {
+        std::fprintf(stderr, "--trace: profiling is compiled out (DSG_ENABLE_PROFILING=OFF)\n");
+        return;
+    }
+    std::fprintf(stderr, "%-28s %8s %12s %12s %14s %14s %12s\n", "stage", "calls", "total ms", "max ms", "bits",
+                 "samples", "alloc MiB");
+    for (const profiler::StageStats& st : profiler::summary())
+        std::fprintf(stderr, "%-28s %8llu %12.3f %12.3f %14llu %14llu %12.2f\n", st.name.c_str(),
+                     (unsigned long long)st.calls, st.total_ns / 1e6, st.max_ns / 1e6,
+                     (unsigned long long)st.counters.bits, (unsigned long long)st.counters.samples,
+                     st.counters.bytes / (1024.0 * 1024.0));
+    profiler::write_chrome_trace(path);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt = parse_args(argc, argv);
+    // nothing is recorded unless a trace was asked for
+    profiler::set_enabled(!opt.trace.empty());
+    try {
+        int rc = run(opt);
+        if (!opt.trace.empty()) write_trace(opt.trace);
+        return rc;
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "error: %s\n", e.what());
+        return 1;
+    }
+}
@@ -1,14 +1,60 @@
+#include "BackgroundJob.hpp"
+#include "BerSweep.hpp"
 #include "DigitalSignalGenerator.hpp"
+#include "EncodeCache.hpp"
+#include "MinMaxPyramid.hpp"
+#include "Palindrome.hpp"
+#include "Profiler.hpp"
+#include "SimdKernels.hpp"
+#include "Spectrum.hpp"
 #include <imgui.h>
 #include <backends/imgui_impl_glfw.h>
 #include <backends/imgui_impl_opengl3.h>
 #include <implot.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
 #include <vector>
 #include <string>
 #include <sstream>
 #include <iomanip>
 
+// Everything one Generate produces. Built on the worker thread and swapped in whole;
+// the next Generate refills the one it replaced (DoubleBuffer::reclaim).
+struct GeneratedSignal {
+    std::string data;
+    LineCode code = LineCode::NRZ_L;
+    Scrambler scrambler = Scrambler::None;   // AMI only
+    RunLengthSignal signal;           // runs only; dense samples exist just for the visible window
+    MinMaxPyramid lod;
+    PowerSpectrum psd;
+    size_t psd_segment = 0;
+    std::string report;
+};
+
+// Welch segment for the chosen length: halved (down to 64) until it fits the signal
+static size_t psd_segment_for(size_t chosen, std::uint64_t samples) {
+    size_t seg = chosen;
+    while (seg > 64 && seg > samples) seg /= 2;
+    return seg;
+}
+
+// PSD in dB over frequency in multiples of the bit rate, for plotting
+static void psd_plot_data(const PowerSpectrum& psd, double bit_duration, std::vector<double>& x, std::vector<double>& y) {
+    x.resize(psd.density.size());
+    y.resize(psd.density.size());
+    for (size_t k = 0; k < psd.density.size(); ++k) {
+        x[k] = psd.frequency(k) * bit_duration;
+        y[k] = 10.0 * std::log10(std::max(psd.density[k], 1e-12));
+    }
+}
+
+static std::string clip80(const std::string& s) {
+    return s.size() > 80 ? s.substr(0,80) + "..." : s;
+}
+
 static void glfw_error_callback(int error, const char* description) {
     fprintf(stderr, "Glfw Error %d: %s\n", error, description);
 }
@@ -42,7 +88,7 @@ int main(int, char**) {
     // State
     DigitalSignalGenerator gen(1.0, 200);
     char binary_input_c[1024] = "1100100100110";
-    bool input_is_digital = true;
+    int input_is_digital = 1;
     int pcm_bits = 8;
     double dm_step = 0.15;
     int sampling_rate = gen.sampling_rate;
@@ -51,13 +97,49 @@ int main(int, char**) {
     // encoding scheme
     int encoding_idx = 0;
     const char* encoding_names[] = {"NRZ-L","NRZ-I","Manchester","Diff Manchester","AMI"};
-    std::string current_data;
-    std::vector<double> current_time, current_signal;
+    GeneratedSignal current;          // front buffer, only touched by the render thread
+    std::vector<float> plot_window;
+    std::vector<double> plot_lod_x;
+    std::vector<double> plot_lod_y;
+    bool fit_plot = false;
     std::string output_report;
 
+    // power spectral density (Spectrum.hpp), computed with each Generate and again on
+    // the worker when the segment length changes
+    int psd_segment_idx = 2;
+    const size_t psd_segments[] = {256, 1024, 4096, 16384};
+    DoubleBuffer<PowerSpectrum> spectra;
+    std::vector<double> psd_x, psd_y;
+
+    // worker-only state, declared first so it outlives the job: re-encoding resumes from
+    // the first edited bit (EncodeCache.hpp), and the palindrome of the last input is
+    // kept, since Manacher has no incremental form but a scheme switch keeps the input
+    EncodeCache encode_cache(8, 256);
+    std::string palindrome_input;
+    Palindrome palindrome_result;
+
+    // Generate / Decode run on a worker; results come back through double buffers,
+    // declared before the job so ~BackgroundJob joins the worker while they still exist
+    DoubleBuffer<GeneratedSignal> generated;
+    DoubleBuffer<std::string> reports;
+    BackgroundJob job;
+
+    // noisy channel for Decode and the BER sweep; the sweep has its own worker
+    bool use_channel = false;
+    double channel_ebn0 = 6.0, channel_attenuation = 0.0, channel_jitter = 0.0;
+    DoubleBuffer<std::vector<BerCurve>> sweeps;   // before sweep_job: outlives its worker
+    BackgroundJob sweep_job;
+    std::vector<BerCurve> ber_curves;
+    double sweep_min = 0.0, sweep_max = 10.0, sweep_step = 1.0, sweep_bits = 1e6;
+    int sweep_sampling_rate = 8;
+
     bool use_scrambling = false;
     int scramble_idx = 0; // 0 B8ZS, 1 HDB3
 
+    // stage timings (Profiler.hpp), shown under the plot
+    char trace_path[256] = "dsg_trace.json";
+    std::string trace_status;
+
     // main loop
     while (!glfwWindowShouldClose(window)) {
         glfwPollEvents();
@@ -65,6 +147,16 @@ int main(int, char**) {
         ImGui_ImplGlfw_NewFrame();
         ImGui::NewFrame();
 
+        if (generated.take(current)) {
+            output_report = current.report;
+            fit_plot = true;
+            psd_plot_data(current.psd, gen.bit_duration, psd_x, psd_y);
+        }
+        if (spectra.take(current.psd)) psd_plot_data(current.psd, gen.bit_duration, psd_x, psd_y);
+        reports.take(output_report);
+        sweeps.take(ber_curves);
+        if (!job.running() && !job.error().empty()) output_report = "Error: " + job.error() + "\n";
+
         // Left panel: controls
         ImGui::Begin("Controls", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
@@ -90,117 +182,346 @@ int main(int, char**) {
         ImGui::Checkbox("Apply Scrambling (AMI only)", &use_scrambling);
         ImGui::Combo("Scrambling", &scramble_idx, "B8ZS\0HDB3\0");
 
+        bool busy = job.running();
+        if (busy) ImGui::BeginDisabled();
         if (ImGui::Button("Generate Signal")) {
-            output_report.clear();
-            if (input_is_digital) {
-                current_data = std::string(binary_input_c);
-                // sanitize
-                current_data.erase(std::remove_if(current_data.begin(), current_data.end(), [](char c){return c!='0' && c!='1';}), current_data.end());
-                if (current_data.empty()) current_data = "0";
-            } else {
-                // generate simple analog signal (sine)
-                std::vector<double> analog;
-                int N = 50;
-                analog.reserve(N);
-                for (int i=0;i<N;++i) analog.push_back(std::sin(2.0*M_PI*(double)i/(double)N));
-                current_data = (pcm_bits>0) ? gen.pcm_encode(analog, pcm_bits) : gen.delta_modulation(analog, dm_step);
-            }
+            std::string input = binary_input_c;
+            bool digital = input_is_digital != 0;
+            int bits = pcm_bits;
+            double step = dm_step;
+            LineCode code = static_cast<LineCode>(encoding_idx);
+            Scrambler scrambler = (encoding_idx==4 && use_scrambling) ? (scramble_idx==0 ? Scrambler::B8ZS : Scrambler::HDB3) : Scrambler::None;
+            size_t psd_chosen = psd_segments[psd_segment_idx];
+            job.start([&generated, &encode_cache, &palindrome_input, &palindrome_result, gen, input, digital, bits, step, code, scrambler, psd_chosen](BackgroundJob::Context& ctx) {
+                DSG_PROFILE_SCOPE(prof, "generate");
+                // refill the buffers of the signal this one replaces
+                GeneratedSignal out = generated.reclaim();
+                out.code = code;
+                out.scrambler = scrambler;
+                ctx.step(0.0, "input");
+                if (digital) {
+                    out.data = input;
+                    // sanitize
+                    out.data.erase(std::remove_if(out.data.begin(), out.data.end(), [](char c){return c!='0' && c!='1';}), out.data.end());
+                    if (out.data.empty()) out.data = "0";
+                } else {
+                    // generate simple analog signal (sine)
+                    std::vector<double> analog;
+                    int N = 50;
+                    analog.reserve(N);
+                    for (int i=0;i<N;++i) analog.push_back(std::sin(2.0*M_PI*(double)i/(double)N));
+                    out.data = (bits>0) ? gen.pcm_encode(analog, bits) : gen.delta_modulation(analog, step);
+                }
 
-            // palindrome
-            auto [pal, start, plen] = gen.longest_palindrome_manacher(current_data);
+                // palindrome, on the packed bits the encoder uses too
+                ctx.step(0.1, "palindrome");
+                BitStream packed(out.data);
+                bool palindrome_cached = out.data == palindrome_input;
+                if (!palindrome_cached) {
+                    palindrome_result = longest_palindrome(packed, [&ctx](double f) { ctx.step(0.1 + 0.3 * f, "palindrome"); });
+                    palindrome_input = out.data;
+                }
+                Palindrome pal = palindrome_result;
 
-            // encode
-            switch(encoding_idx) {
-                case 0: tie(current_time, current_signal) = gen.nrz_l(current_data); break;
-                case 1: tie(current_time, current_signal) = gen.nrz_i(current_data); break;
-                case 2: tie(current_time, current_signal) = gen.manchester(current_data); break;
-                case 3: tie(current_time, current_signal) = gen.differential_manchester(current_data); break;
-                case 4: tie(current_time, current_signal) = gen.ami(current_data); break;
-            }
+                // encode
+                ctx.step(0.4, "encode");
+                // scrambled AMI is plotted with its real substituted bipolar levels
+                out.signal = encode_cache.encode(packed, code, gen.bit_duration, gen.sampling_rate, scrambler,
+                                                 [&ctx](double f) { ctx.step(0.4 + 0.2 * f, "encode"); });
+                ctx.step(0.6, "plot pyramid");
+                out.lod.build(out.signal);
 
-            std::string scrambled;
-            if (encoding_idx==4 && use_scrambling) {
-                scrambled = (scramble_idx==0) ? gen.b8zs_scramble(current_data) : gen.hdb3_scramble(current_data);
-            }
+                ctx.step(0.65, "spectrum");
+                out.psd_segment = psd_segment_for(psd_chosen, out.signal.count);
+                welch_psd(out.signal, out.psd_segment, out.psd, ThreadPool::shared(),
+                          [&ctx](double f) { ctx.step(0.65 + 0.05 * f, "spectrum"); });
 
-            std::ostringstream rep;
-            rep << "================ SIGNAL GENERATION REPORT ================\n";
-            rep << "Input Data: " << (current_data.size() > 80 ? current_data.substr(0,80) + "..." : current_data) << "\n";
-            rep << "Bits: " << current_data.size() << "\n";
-            rep << "Encoding: " << encoding_names[encoding_idx] << "\n\n";
-            rep << "---------------- PALINDROME ----------------\n";
-            rep << "Longest palindrome: \"" << pal << "\" start=" << start << " len=" << plen << "\n\n";
-            if (!scrambled.empty()) {
-                rep << "---------------- SCRAMBLING ----------------\n";
-                rep << "Type: " << (scramble_idx==0 ? "B8ZS" : "HDB3") << "\n";
-                rep << "Scrambled: " << (scrambled.size() > 80 ? scrambled.substr(0,80)+"..." : scrambled) << "\n\n";
-            }
-            double mean = 0.0, stddev = 0.0;
-            if (!current_signal.empty()) {
-                mean = std::accumulate(current_signal.begin(), current_signal.end(), 0.0) / current_signal.size();
-                double var = 0.0;
-                for (double v : current_signal) var += (v-mean)*(v-mean);
-                var /= current_signal.size();
-                stddev = std::sqrt(var);
-            }
-            rep << "Signal Mean: " << mean << " Std: " << stddev << "\n";
-            rep << "Click Decode to decode the plotted signal.\n";
-            output_report = rep.str();
+                ctx.step(0.7, "scramble");
+                std::string scrambled;
+                if (scrambler != Scrambler::None) {
+                    scrambled = (scrambler==Scrambler::B8ZS) ? gen.b8zs_scramble(out.data) : gen.hdb3_scramble(out.data);
+                }
+
+                ctx.step(0.85, "statistics");
+                std::ostringstream rep;
+                rep << "================ SIGNAL GENERATION REPORT ================\n";
+                rep << "Input Data: " << clip80(out.data) << "\n";
+                rep << "Bits: " << out.data.size() << "\n";
+                rep << "Encoding: " << line_code_name(code) << "\n\n";
+                rep << "---------------- PALINDROME ----------------\n";
+                rep << "Longest palindrome: \"" << clip80(out.data.substr((size_t)pal.start, (size_t)pal.length)) << "\" start=" << pal.start
+                    << " len=" << pal.length << "\n\n";
+                if (!scrambled.empty()) {
+                    rep << "---------------- SCRAMBLING ----------------\n";
+                    rep << "Type: " << scrambler_name(scrambler) << "\n";
+                    rep << "Scrambled: " << clip80(scrambled) << "\n\n";
+                }
+                double mean, stddev;
+                {
+                    DSG_PROFILE_SCOPE(stats_prof, "statistics");
+                    mean = out.signal.mean();
+                    stddev = out.signal.stddev();
+                    DSG_PROFILE_COUNT(stats_prof, 0, out.signal.count, 0);
+                }
+                rep << "Samples: " << out.signal.count << "  Runs: " << out.signal.run_count() << "\n";
+                switch (encode_cache.last_outcome()) {
+                case EncodeCache::Outcome::Hit: rep << "Encode cache: hit\n"; break;
+                case EncodeCache::Outcome::Resumed: rep << "Encode cache: resumed at bit " << encode_cache.last_resume_bit() << "\n"; break;
+                case EncodeCache::Outcome::Encoded: rep << "Encode cache: full encode\n"; break;
+                }
+                if (palindrome_cached) rep << "Palindrome: cached\n";
+                rep << "Signal Mean: " << mean << " Std: " << stddev << "\n\n";
+                rep << "---------------- SPECTRUM ----------------\n";
+                rep << "Welch: segment " << out.psd_segment << ", " << out.psd.frames << " frames (Hann, 50% overlap)\n";
+                rep << "DC power: " << mean * mean << " of " << mean * mean + stddev * stddev << "\n";
+                rep << "90% power bandwidth: " << out.psd.band_edge(0.9) * gen.bit_duration << " x bit rate\n";
+                double null = out.psd.first_null();
+                if (null > 0) rep << "First spectral null: " << null * gen.bit_duration << " x bit rate\n";
+                rep << "\n";
+                rep << "Click Decode to decode the plotted signal.\n";
+                out.report = rep.str();
+                ctx.step(1.0, "done");
+                generated.publish(std::move(out));
+            });
         }
 
         ImGui::SameLine();
         if (ImGui::Button("Clear")) {
-            current_data.clear();
-            current_time.clear();
-            current_signal.clear();
+            current = GeneratedSignal();
+            plot_window.clear();
+            psd_x.clear();
+            psd_y.clear();
             output_report.clear();
             strcpy(binary_input_c, "1100100100110");
         }
 
         ImGui::Separator();
+        ImGui::Checkbox("Noisy channel on Decode", &use_channel);
+        ImGui::InputDouble("Eb/N0 (dB)", &channel_ebn0, 0.5, 2.0, "%.1f");
+        ImGui::InputDouble("Attenuation (dB)", &channel_attenuation, 0.5, 2.0, "%.1f");
+        ImGui::InputDouble("Jitter (bit rms)", &channel_jitter, 0.01, 0.05, "%.3f");
+        channel_attenuation = std::max(0.0, channel_attenuation);
+        channel_jitter = std::clamp(channel_jitter, 0.0, 0.5);
+        ChannelModel channel;
+        channel.ebn0_db = channel_ebn0;
+        channel.attenuation_db = channel_attenuation;
+        channel.jitter = channel_jitter;
+
         if (ImGui::Button("Decode Signal")) {
-            if (current_signal.empty()) {
+            if (current.signal.empty()) {
                 output_report = "Generate signal first.\n";
             } else {
-                std::string decoded;
-                switch(encoding_idx) {
-                    case 0: decoded = gen.decode_nrz_l(current_signal); break;
-                    case 1: decoded = gen.decode_nrz_i(current_signal); break;
-                    case 2: decoded = gen.decode_manchester(current_signal); break;
-                    case 3: decoded = gen.decode_differential_manchester(current_signal); break;
-                    case 4: decoded = gen.decode_ami(current_signal); break;
-                }
-                // compute accuracy
-                size_t matches = 0;
-                for (size_t i=0;i< std::min(decoded.size(), current_data.size()); ++i) if (decoded[i]==current_data[i]) ++matches;
-                double acc = current_data.empty() ? 0.0 : (100.0 * (double)matches / (double)current_data.size());
-                std::ostringstream rep;
-                rep << "================ DECODING REPORT ================\n";
-                rep << "Original : " << (current_data.size() > 80 ? current_data.substr(0,80)+"..." : current_data) << "\n";
-                rep << "Decoded  : " << (decoded.size() > 80 ? decoded.substr(0,80)+"..." : decoded) << "\n";
-                rep << "Correct: " << matches << "/" << current_data.size() << "  Accuracy: " << std::fixed << std::setprecision(2) << acc << "%\n";
-                output_report = rep.str();
+                // the worker gets its own copy of the runs; the front buffer may be swapped meanwhile
+                bool noisy = use_channel;
+                job.start([&reports, gen, data = current.data, signal = current.signal, code = current.code,
+                           scrambler = current.scrambler, noisy, channel](BackgroundJob::Context& ctx) {
+                    DSG_PROFILE_SCOPE(prof, "decode_job");
+                    BitStream bits;
+                    if (noisy) {
+                        // frame by frame, as the BER sweep runs it: Cancel is polled per frame
+                        // and the dense received waveform is never held whole
+                        size_t spb = (size_t)samples_per_bit(code, gen.sampling_rate);
+                        size_t n = (size_t)(signal.count / spb);
+                        const size_t frame_bits = 64 * 1024;
+                        std::vector<float> clean, received;
+                        std::vector<double> sums;
+                        std::vector<std::int8_t> symbols;
+                        StreamDecoderF dec(code, gen.sampling_rate);
+                        AmiDescrambler descrambler(scrambler);
+                        for (size_t first = 0; first < n; first += frame_bits) {
+                            ctx.step(0.8 * (double)first / (double)n, "channel + decode");
+                            size_t m = std::min(frame_bits, n - first);
+                            clean.resize(m * spb);
+                            received.resize(clean.size());
+                            signal.sample(first * spb, clean.size(), clean.data());
+                            apply_channel(channel, clean.data(), clean.size(), spb, first * spb, received.data());
+                            if (scrambler != Scrambler::None) {
+                                sums.resize(m);
+                                symbols.resize(m);
+                                simd::segment_sums(received.data(), m, spb, 0, spb, sums.data());
+                                ami_symbols(sums.data(), m, gen.sampling_rate, symbols.data());
+                                descrambler.push(symbols.data(), m, bits);
+                            } else {
+                                dec.decode(received.data(), received.size(), bits);
+                            }
+                        }
+                        if (scrambler != Scrambler::None) descrambler.finish(bits);
+                    } else {
+                        ctx.step(0.0, "decode");
+                        bits = scrambler != Scrambler::None ? gen.decode_ami_scrambled(signal, scrambler) : gen.decode(code, signal);
+                    }
+                    std::string decoded = bits.to_string();
+                    ctx.step(0.8, "compare");
+                    // compute accuracy
+                    size_t matches = 0;
+                    for (size_t i=0;i< std::min(decoded.size(), data.size()); ++i) if (decoded[i]==data[i]) ++matches;
+                    double acc = data.empty() ? 0.0 : (100.0 * (double)matches / (double)data.size());
+                    std::ostringstream rep;
+                    rep << "================ DECODING REPORT ================\n";
+                    if (noisy) rep << "Channel: Eb/N0 " << channel.ebn0_db << " dB, attenuation " << channel.attenuation_db
+                                   << " dB, jitter " << channel.jitter << " bit rms\n";
+                    rep << "Original : " << clip80(data) << "\n";
+                    rep << "Decoded  : " << clip80(decoded) << "\n";
+                    rep << "Correct: " << matches << "/" << data.size() << "  Accuracy: " << std::fixed << std::setprecision(2) << acc << "%\n";
+                    if (noisy) rep << "Bit errors: " << data.size() - matches << "  BER: " << std::scientific << std::setprecision(3)
+                                   << (data.empty() ? 0.0 : (double)(data.size() - matches) / (double)data.size()) << "\n";
+                    ctx.step(1.0, "done");
+                    reports.publish(rep.str());
+                });
             }
         }
+        if (busy) ImGui::EndDisabled();
+
+        if (busy) {
+            std::string label = job.cancelling() ? std::string("cancelling...") : job.stage();
+            ImGui::ProgressBar((float)job.progress(), ImVec2(-1, 0), label.c_str());
+            if (!job.cancelling() && ImGui::Button("Cancel")) job.cancel();
+        }
 
         ImGui::End();
 
         // Right: plotting & output
         ImGui::Begin("Signal & Output", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
-        if (!current_time.empty() && !current_signal.empty()) {
+        if (!current.signal.empty()) {
             if (ImPlot::BeginPlot("Signal Plot", ImVec2(-1,300))) {
                 ImPlot::SetupAxes("Time", "Voltage");
-                ImPlot::SetupAxisLimits(ImAxis_X1, current_time.front(), current_time.back(), ImGuiCond_Always);
+                ImPlot::SetupAxisLimits(ImAxis_X1, current.signal.time(0), current.signal.time(current.signal.count-1), fit_plot ? ImGuiCond_Always : ImGuiCond_Once);
                 ImPlot::SetupAxisLimits(ImAxis_Y1, -1.5, 1.5, ImGuiCond_Always);
-                ImPlot::PlotLine("Signal", current_time.data(), current_signal.data(), (int)current_signal.size());
+                fit_plot = false;
+                // about one min/max pair per pixel from the pyramid; when zoomed in far enough,
+                // expand only the visible window of the runs (implicit x axis: x_i = t0 + i*dt)
+                ImPlotRect view = ImPlot::GetPlotLimits();
+                auto [first, last] = current.signal.sample_range(view.X.Min, view.X.Max);
+                size_t pixels = (size_t)std::max(1.0f, ImPlot::GetPlotSize().x);
+                if (current.lod.decimate(first, last, pixels, plot_lod_x, plot_lod_y)) {
+                    ImPlot::PlotLine("Signal", plot_lod_x.data(), plot_lod_y.data(), (int)plot_lod_x.size());
+                } else {
+                    plot_window.resize((size_t)(last - first));
+                    current.signal.sample(first, plot_window.size(), plot_window.data());
+                    ImPlot::PlotLine("Signal", plot_window.data(), (int)plot_window.size(), current.signal.dt, current.signal.time(first));
+                }
                 ImPlot::EndPlot();
             }
+            if (ImPlot::BeginPlot("Power Spectral Density", ImVec2(-1,220))) {
+                ImPlot::SetupAxes("Frequency (x bit rate)", "PSD (dB)");
+                ImPlot::SetupAxisLimits(ImAxis_X1, 0.0, 4.0, ImGuiCond_Once);
+                ImPlot::SetupAxisLimits(ImAxis_Y1, -60.0, 10.0, ImGuiCond_Once);
+                if (!psd_x.empty()) ImPlot::PlotLine("PSD", psd_x.data(), psd_y.data(), (int)psd_x.size());
+                ImPlot::EndPlot();
+            }
+            ImGui::SetNextItemWidth(120);
+            if (ImGui::Combo("PSD segment", &psd_segment_idx, "256\0" "1024\0" "4096\0" "16384\0") && !job.running()) {
+                // the worker gets its own copy of the runs, as for Decode
+                size_t segment = psd_segment_for(psd_segments[psd_segment_idx], current.signal.count);
+                current.psd_segment = segment;
+                job.start([&spectra, signal = current.signal, segment](BackgroundJob::Context& ctx) {
+                    ctx.step(0.0, "spectrum");
+                    PowerSpectrum psd = welch_psd(signal, segment, ThreadPool::shared(), [&ctx](double f) { ctx.step(f, "spectrum"); });
+                    ctx.step(1.0, "done");
+                    spectra.publish(std::move(psd));
+                });
+            }
         } else {
             ImGui::TextWrapped("No signal generated yet. Click Generate Signal.");
         }
 
         ImGui::Separator();
         ImGui::TextUnformatted(output_report.c_str());
+
+        if (ImGui::CollapsingHeader("Profile")) {
+            if (!profiler::compiled_in) {
+                ImGui::TextWrapped("Profiling is compiled out (DSG_ENABLE_PROFILING=OFF).");
+            } else {
+                bool recording = profiler::enabled();
+                if (ImGui::Checkbox("Record", &recording)) profiler::set_enabled(recording);
+                ImGui::SameLine();
+                if (ImGui::Button("Reset##profile")) { profiler::reset(); trace_status.clear(); }
+                ImGui::SameLine();
+                if (ImGui::Button("Save Chrome Trace")) {
+                    try {
+                        profiler::write_chrome_trace(trace_path);
+                        trace_status = std::string("Wrote ") + trace_path;
+                    } catch (const std::exception& e) {
+                        trace_status = e.what();
+                    }
+                }
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(220);
+                ImGui::InputText("##trace_path", trace_path, IM_ARRAYSIZE(trace_path));
+                if (!trace_status.empty()) ImGui::TextUnformatted(trace_status.c_str());
+                std::vector<profiler::StageStats> stages = profiler::summary();
+                if (ImGui::BeginTable("profile_stages", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg)) {
+                    for (const char* h : {"Stage", "Calls", "Total ms", "Max ms", "Bits", "Samples", "Alloc KiB"})
+                        ImGui::TableSetupColumn(h);
+                    ImGui::TableHeadersRow();
+                    for (const profiler::StageStats& st : stages) {
+                        ImGui::TableNextRow();
+                        ImGui::TableNextColumn(); ImGui::TextUnformatted(st.name.c_str());
+                        ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)st.calls);
+                        ImGui::TableNextColumn(); ImGui::Text("%.3f", st.total_ns / 1e6);
+                        ImGui::TableNextColumn(); ImGui::Text("%.3f", st.max_ns / 1e6);
+                        ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)st.counters.bits);
+                        ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)st.counters.samples);
+                        ImGui::TableNextColumn(); ImGui::Text("%.1f", st.counters.bytes / 1024.0);
+                    }
+                    ImGui::EndTable();
+                }
+                if (std::uint64_t d = profiler::dropped()) ImGui::Text("%llu newest events not kept in the trace", (unsigned long long)d);
+            }
+        }
+        ImGui::End();
+
+        // BER vs Eb/N0 of all five codes over the channel above (noise level swept)
+        ImGui::Begin("BER Sweep", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
+        ImGui::InputDouble("Eb/N0 min", &sweep_min, 1.0, 2.0, "%.1f");
+        ImGui::InputDouble("Eb/N0 max", &sweep_max, 1.0, 2.0, "%.1f");
+        ImGui::InputDouble("Eb/N0 step", &sweep_step, 0.5, 1.0, "%.2f");
+        ImGui::InputDouble("Bits per point", &sweep_bits, 0, 0, "%.3g");
+        ImGui::InputInt("Samples per bit", &sweep_sampling_rate);
+        sweep_step = std::max(0.1, sweep_step);
+        sweep_max = std::max(sweep_min, sweep_max);
+        sweep_bits = std::clamp(sweep_bits, 1e3, 1e12);
+        sweep_sampling_rate = std::clamp(sweep_sampling_rate, 2, 1000);
+        bool sweeping = sweep_job.running();
+        if (sweeping) ImGui::BeginDisabled();
+        if (ImGui::Button("Run Sweep")) {
+            BerSweepConfig cfg;
+            cfg.ebn0_min_db = sweep_min;
+            cfg.ebn0_max_db = sweep_max;
+            cfg.ebn0_step_db = sweep_step;
+            cfg.bits_per_point = (std::uint64_t)sweep_bits;
+            cfg.sampling_rate = sweep_sampling_rate;
+            cfg.attenuation_db = channel.attenuation_db;
+            cfg.jitter = channel.jitter;
+            sweep_job.start([&sweeps, cfg](BackgroundJob::Context& ctx) {
+                auto curves = ber_sweep(cfg, ThreadPool::shared(), [&ctx](double f) { ctx.step(f, "simulating"); });
+                sweeps.publish(std::move(curves));
+            });
+        }
+        if (sweeping) ImGui::EndDisabled();
+        if (sweeping) {
+            std::string label = sweep_job.cancelling() ? std::string("cancelling...") : sweep_job.stage();
+            ImGui::ProgressBar((float)sweep_job.progress(), ImVec2(-1, 0), label.c_str());
+            if (!sweep_job.cancelling() && ImGui::Button("Cancel##sweep")) sweep_job.cancel();
+        }
+        if (!sweep_job.running() && !sweep_job.error().empty()) ImGui::Text("Error: %s", sweep_job.error().c_str());
+        if (!ber_curves.empty() && ImPlot::BeginPlot("BER vs Eb/N0", ImVec2(600, 350))) {
+            ImPlot::SetupAxes("Eb/N0 (dB)", "BER");
+            ImPlot::SetupAxisScale(ImAxis_Y1, ImPlotScale_Log10);
+            ImPlot::SetupAxisLimits(ImAxis_Y1, 1e-7, 1.0, ImGuiCond_Once);
+            std::vector<double> xs, ys;
+            for (const BerCurve& curve : ber_curves) {
+                xs.clear(); ys.clear();
+                // points without errors have no place on a log axis
+                for (const BerPoint& p : curve.points)
+                    if (p.errors) { xs.push_back(p.ebn0_db); ys.push_back(p.ber()); }
+                ImPlot::PlotLine(line_code_name(curve.code), xs.data(), ys.data(), (int)xs.size());
+            }
+            xs.clear(); ys.clear();
+            for (const BerPoint& p : ber_curves[0].points) { xs.push_back(p.ebn0_db); ys.push_back(ber_antipodal(p.ebn0_db)); }
+            ImPlot::PlotLine("Antipodal theory", xs.data(), ys.data(), (int)xs.size());
+            ImPlot::EndPlot();
+        }
         ImGui::End();
 
         // Render